@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/encode.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace base64::detail::autotune
+{
+
+/// Input size per measured kernel call, small enough to stay in L1 cache.
+constexpr inline size_t sample_size = 12 * 1024;
+
+/// Number of measured rounds. All kernels are run once per round, so that
+/// frequency changes during calibration affect them alike.
+constexpr inline unsigned rounds = 16;
+
+/// @returns the name of the fastest kernel of @p _kernels on the running CPU,
+///          taking the minimum time over all rounds of @p _size bytes each.
+template <typename Fn, size_t N>
+std::string_view fastest(std::array<dispatch::kernel<Fn>, N> const& _kernels,
+                         uint8_t const* _input,
+                         size_t _size,
+                         uint8_t* _output)
+{
+    using clock = std::chrono::steady_clock;
+
+    auto const available = cpu::available_features();
+    std::array<clock::duration, N> best;
+    best.fill(clock::duration::max());
+
+    // round 0 warms up caches and branch predictors and is not measured
+    for (unsigned round = 0; round <= rounds; ++round)
+    {
+        for (size_t k = 0; k < N; ++k)
+        {
+            if (!dispatch::is_supported(_kernels[k], available))
+                continue;
+
+            auto const start = clock::now();
+            _kernels[k].function(_input, _size, _output);
+            auto const elapsed = clock::now() - start;
+
+            if (round && elapsed < best[k])
+                best[k] = elapsed;
+        }
+    }
+
+    size_t winner = N - 1;
+    for (size_t k = 0; k < N; ++k)
+        if (best[k] < best[winner])
+            winner = k;
+    return _kernels[winner].name;
+}
+
+/// @returns the supported kernel of @p _kernels named @p _name, or nullptr.
+template <typename Fn, size_t N>
+dispatch::kernel<Fn> const* find(std::array<dispatch::kernel<Fn>, N> const& _kernels, std::string_view _name) noexcept
+{
+    auto const available = cpu::available_features();
+    for (auto const& k: _kernels)
+        if (k.name == _name && dispatch::is_supported(k, available))
+            return &k;
+    return nullptr;
+}
+
+/// Cache file entry: one line of "<codec> <kernel> <cpu model>".
+struct cache_entry
+{
+    std::string codec;
+    std::string kernel;
+    std::string model;
+};
+
+inline std::vector<cache_entry> read_cache(std::string const& _path)
+{
+    std::vector<cache_entry> entries;
+    std::ifstream file(_path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        cache_entry entry;
+        if (fields >> entry.codec >> entry.kernel >> std::ws && std::getline(fields, entry.model))
+            entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+inline void write_cache(std::string const& _path, std::vector<cache_entry> const& _entries)
+{
+    std::ofstream file(_path, std::ios::trunc);
+    for (auto const& entry: _entries)
+        file << entry.codec << ' ' << entry.kernel << ' ' << entry.model << '\n';
+}
+
+} // namespace base64::detail::autotune
+
+namespace base64
+{
+
+struct autotune_result
+{
+    std::string_view decode_kernel; //!< name of the installed decoding kernel
+    std::string_view encode_kernel; //!< name of the installed encoding kernel
+    bool from_cache;                //!< whether the choice was read from the cache file
+};
+
+/// Measures all decoding and encoding kernels supported by the running CPU
+/// and installs the fastest ones in the dispatcher, replacing the static
+/// choice based on CPU features alone. The calibration takes a few
+/// milliseconds.
+///
+/// If @p _cachePath is not empty, the choice is looked up there first, keyed
+/// by the CPU model name, and stored there after a calibration, so that later
+/// process starts on the same host skip it. The cache is best effort: an
+/// unreadable or unwritable file only costs a calibration.
+///
+/// Call it at startup, before other threads use the codec. It has no effect
+/// on the block functions of the compiled library (BASE64_CPP_COMPILED), whose
+/// kernels are bound at load time.
+inline autotune_result autotune(std::string const& _cachePath = {})
+{
+    using namespace detail;
+
+    auto model = cpu::model_name();
+    if (model.empty())
+        model = "unknown";
+
+    std::vector<autotune::cache_entry> entries;
+    if (!_cachePath.empty())
+    {
+        entries = autotune::read_cache(_cachePath);
+
+        dispatch::kernel<decoder::kernel_fn> const* decodeKernel = nullptr;
+        dispatch::kernel<encoder::kernel_fn> const* encodeKernel = nullptr;
+        for (auto const& entry: entries)
+        {
+            if (entry.model != model)
+                continue;
+            if (entry.codec == "decode")
+                decodeKernel = autotune::find(decoder::kernels, entry.kernel);
+            else if (entry.codec == "encode")
+                encodeKernel = autotune::find(encoder::kernels, entry.kernel);
+        }
+
+        if (decodeKernel && encodeKernel)
+        {
+            decoder::selected_kernel() = decodeKernel->function;
+            encoder::selected_kernel() = encodeKernel->function;
+            return {decodeKernel->name, encodeKernel->name, true};
+        }
+    }
+
+    // Bytes and their encoding, as input for the encoding and decoding kernels.
+    std::vector<uint8_t> bytes(autotune::sample_size);
+    uint32_t seed = 0x12345678;
+    for (auto& b: bytes)
+    {
+        seed = seed * 1664525 + 1013904223;
+        b = static_cast<uint8_t>(seed >> 24);
+    }
+    std::vector<uint8_t> chars((bytes.size() / 3) * 4);
+    encoder::simple::encode_blocks(bytes.data(), bytes.size(), chars.data());
+    std::vector<uint8_t> output(chars.size());
+
+    auto const decodeName = autotune::fastest(decoder::kernels, chars.data(), chars.size(), output.data());
+    auto const encodeName = autotune::fastest(encoder::kernels, bytes.data(), bytes.size(), output.data());
+
+    decoder::selected_kernel() = autotune::find(decoder::kernels, decodeName)->function;
+    encoder::selected_kernel() = autotune::find(encoder::kernels, encodeName)->function;
+
+    if (!_cachePath.empty())
+    {
+        auto const stale = [&](autotune::cache_entry const& entry) { return entry.model == model; };
+        entries.erase(std::remove_if(entries.begin(), entries.end(), stale), entries.end());
+        entries.push_back({"decode", std::string(decodeName), model});
+        entries.push_back({"encode", std::string(encodeName), model});
+        autotune::write_cache(_cachePath, entries);
+    }
+
+    return {decodeName, encodeName, false};
+}
+
+} // namespace base64
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/detail/base16-avx2.hpp>
+#include <base64-cpp/detail/compiled.hpp>
+#include <base64-cpp/detail/base16-simple.hpp>
+#include <base64-cpp/detail/base16-sse.hpp>
+#include <base64-cpp/detail/dispatch.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace base16::detail
+{
+
+namespace dispatch = base64::detail::dispatch;
+namespace cpu = base64::detail::cpu;
+
+/// Decoding kernel: decodes @p _size hex digits (an even number) into _size / 2 bytes.
+/// Encoding kernel: encodes @p _size bytes into 2 * _size hex digits.
+using kernel_fn = void (*)(uint8_t const* _input, size_t _size, uint8_t* _output);
+
+/// All decoding kernels, ordered from best to worst.
+inline constexpr std::array decode_kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<kernel_fn>{"avx2", cpu::to_set(cpu::feature::AVX2), &avx2::decode_pshufb},
+    dispatch::kernel<kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &sse::decode_pshufb},
+#endif
+    dispatch::kernel<kernel_fn>{"simple", 0, &simple::decode},
+};
+
+/// All encoding kernels, ordered from best to worst.
+inline constexpr std::array encode_kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<kernel_fn>{"avx2", cpu::to_set(cpu::feature::AVX2), &avx2::encode},
+    dispatch::kernel<kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &sse::encode},
+#endif
+    dispatch::kernel<kernel_fn>{"simple", 0, &simple::encode},
+};
+
+inline kernel_fn& selected_decode_kernel() noexcept
+{
+    static kernel_fn kernel = dispatch::select(decode_kernels);
+    return kernel;
+}
+
+inline kernel_fn& selected_encode_kernel() noexcept
+{
+    static kernel_fn kernel = dispatch::select(encode_kernels);
+    return kernel;
+}
+
+}
+
+namespace base16
+{
+
+using invalid_input = base64::detail::decoder::invalid_input;
+
+/// @returns the number of hex digits required to encode @p _size bytes.
+constexpr size_t encoded_size(size_t _size) noexcept
+{
+    return 2 * _size;
+}
+
+/// Encodes @p _size bytes into 2 * _size lower-case hex digits.
+inline void encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+#if defined(BASE64_CPP_COMPILED)
+    base64_cpp_base16_encode(_input, _size, _output);
+#else
+    detail::selected_encode_kernel()(_input, _size, _output);
+#endif
+}
+
+inline std::string encode(std::string_view _input)
+{
+    std::string output;
+    output.resize(encoded_size(_input.size()));
+    encode(reinterpret_cast<uint8_t const*>(_input.data()),
+           _input.size(),
+           reinterpret_cast<uint8_t*>(output.data()));
+    return output;
+}
+
+/// Decodes @p _size case-insensitive hex digits into _size / 2 bytes.
+///
+/// Throws invalid_input with the offset of the first non-hex character, or of
+/// the last character if @p _size is odd.
+inline void decode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    if (_size % 2)
+        throw invalid_input{_size - 1, _input[_size - 1]};
+
+#if defined(BASE64_CPP_COMPILED)
+    base64_cpp_base16_decode(_input, _size, _output);
+#else
+    detail::selected_decode_kernel()(_input, _size, _output);
+#endif
+}
+
+/// Decodes @p _input into @p _output, which must provide room for _input.size() / 2 bytes.
+///
+/// @returns number of bytes written.
+inline size_t decode(std::string_view _input, uint8_t* _output)
+{
+    decode(reinterpret_cast<uint8_t const*>(_input.data()), _input.size(), _output);
+    return _input.size() / 2;
+}
+
+inline std::string decode(std::string_view _input)
+{
+    std::string output;
+    output.resize(_input.size() / 2);
+    decode(_input, reinterpret_cast<uint8_t*>(output.data()));
+    return output;
+}
+
+} // namespace base16
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/detail/base32-simple.hpp>
+#include <base64-cpp/detail/base32-sse.hpp>
+#include <base64-cpp/detail/dispatch.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace base32::detail
+{
+
+namespace dispatch = base64::detail::dispatch;
+namespace cpu = base64::detail::cpu;
+
+/// Decoding kernel: decodes @p _size characters (a multiple of 8) into (_size / 8) * 5 bytes.
+/// Encoding kernel: encodes @p _size bytes (a multiple of 5) into (_size / 5) * 8 characters.
+using kernel_fn = void (*)(uint8_t const* _input, size_t _size, uint8_t* _output);
+
+/// All decoding kernels, ordered from best to worst.
+template <alphabet A>
+inline constexpr std::array decode_kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &sse::decode_pshufb_madd<A>},
+#endif
+    dispatch::kernel<kernel_fn>{"simple", 0, &simple::decode_blocks<A>},
+};
+
+/// All encoding kernels, ordered from best to worst.
+template <alphabet A>
+inline constexpr std::array encode_kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &sse::encode<A>},
+#endif
+    dispatch::kernel<kernel_fn>{"simple", 0, &simple::encode<A>},
+};
+
+template <alphabet A>
+kernel_fn& selected_decode_kernel() noexcept
+{
+    static kernel_fn kernel = dispatch::select(decode_kernels<A>);
+    return kernel;
+}
+
+template <alphabet A>
+kernel_fn& selected_encode_kernel() noexcept
+{
+    static kernel_fn kernel = dispatch::select(encode_kernels<A>);
+    return kernel;
+}
+
+template <alphabet A>
+void encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    auto const mainInputLength = _size - _size % 5;
+    selected_encode_kernel<A>()(_input, mainInputLength, _output);
+    simple::encode<A>(_input + mainInputLength, _size - mainInputLength, _output + (mainInputLength / 5) * 8);
+}
+
+template <alphabet A>
+size_t decode(std::string_view _input, uint8_t* _output)
+{
+    while (!_input.empty() && _input.back() == '=')
+        _input.remove_suffix(1);
+
+    auto const input = reinterpret_cast<uint8_t const*>(_input.data());
+    auto const mainInputLength = _input.size() & ~size_t(7);
+    auto const mainOutputLength = (mainInputLength / 8) * 5;
+
+    selected_decode_kernel<A>()(input, mainInputLength, _output);
+
+    try
+    {
+        return mainOutputLength + simple::decode_tail<A>(input + mainInputLength,
+                                                         _input.size() - mainInputLength,
+                                                         _output + mainOutputLength);
+    }
+    catch (simple::invalid_input const& e)
+    {
+        throw simple::invalid_input{mainInputLength + e.offset, e.byte};
+    }
+}
+
+}
+
+namespace base32
+{
+
+using invalid_input = base64::detail::decoder::invalid_input;
+
+/// @returns the number of characters required to encode @p _size bytes, including padding.
+constexpr size_t encoded_size(size_t _size) noexcept
+{
+    return ((_size + 4) / 5) * 8;
+}
+
+/// Encodes @p _size bytes into encoded_size(_size) characters, including '=' padding.
+inline void encode(uint8_t const* _input, size_t _size, uint8_t* _output, alphabet _alphabet = alphabet::standard)
+{
+    if (_alphabet == alphabet::standard)
+        detail::encode<alphabet::standard>(_input, _size, _output);
+    else
+        detail::encode<alphabet::extended_hex>(_input, _size, _output);
+}
+
+inline std::string encode(std::string_view _input, alphabet _alphabet = alphabet::standard)
+{
+    std::string output;
+    output.resize(encoded_size(_input.size()));
+    encode(reinterpret_cast<uint8_t const*>(_input.data()),
+           _input.size(),
+           reinterpret_cast<uint8_t*>(output.data()),
+           _alphabet);
+    return output;
+}
+
+/// Decodes @p _input, with optional trailing '=' padding and case-insensitive,
+/// into @p _output, which must provide room for at least (5 * _input.size()) / 8 bytes.
+///
+/// Throws invalid_input with the offset of the first non-alphabet character,
+/// or of the last character if the final group has an impossible length.
+///
+/// @returns number of bytes written.
+inline size_t decode(std::string_view _input, uint8_t* _output, alphabet _alphabet = alphabet::standard)
+{
+    if (_alphabet == alphabet::standard)
+        return detail::decode<alphabet::standard>(_input, _output);
+    else
+        return detail::decode<alphabet::extended_hex>(_input, _output);
+}
+
+inline std::string decode(std::string_view _input, alphabet _alphabet = alphabet::standard)
+{
+    std::string output;
+    output.resize((5 * _input.size()) / 8);
+    output.resize(decode(_input, reinterpret_cast<uint8_t*>(output.data()), _alphabet));
+    return output;
+}
+
+} // namespace base32
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/detail/checksum-simple.hpp>
+#include <base64-cpp/detail/decode-checksum-sse.hpp>
+#include <base64-cpp/detail/dispatch.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace base64
+{
+
+struct checksum_result
+{
+    size_t size;       //!< number of decoded bytes
+    uint32_t checksum; //!< checksum over the decoded bytes
+};
+
+namespace detail
+{
+    /// Checksum decoding kernel: decodes like decoder::kernel_fn and returns
+    /// the checksum state @p _state updated with the decoded bytes.
+    using checksum_kernel_fn = uint32_t (*)(uint8_t const* _input, size_t _size, uint8_t* _output, uint32_t _state);
+
+    inline uint32_t decode_crc32c_simple(uint8_t const* _input, size_t _size, uint8_t* _output, uint32_t _crc)
+    {
+        decoder::swar::decode(_input, _size, _output);
+        return checksum::simple::crc32c_update(_crc, _output, (_size / 4) * 3);
+    }
+
+    inline uint32_t decode_adler32_simple(uint8_t const* _input, size_t _size, uint8_t* _output, uint32_t _adler)
+    {
+        decoder::swar::decode(_input, _size, _output);
+        return checksum::simple::adler32_update(_adler, _output, (_size / 4) * 3);
+    }
+
+    /// All CRC32C decoding kernels, ordered from best to worst.
+    inline constexpr std::array crc32c_kernels {
+#if defined(BASE64_CPP_X86)
+        dispatch::kernel<checksum_kernel_fn>{"sse42", cpu::to_set(cpu::feature::SSSE3, cpu::feature::SSE4_2), &decoder::sse::decode_crc32c_pshufb_madd_sse42},
+        dispatch::kernel<checksum_kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &decoder::sse::decode_crc32c_pshufb_madd},
+#endif
+        dispatch::kernel<checksum_kernel_fn>{"simple", 0, &decode_crc32c_simple},
+    };
+
+    /// All Adler-32 decoding kernels, ordered from best to worst.
+    inline constexpr std::array adler32_kernels {
+#if defined(BASE64_CPP_X86)
+        dispatch::kernel<checksum_kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &decoder::sse::decode_adler32_pshufb_madd},
+#endif
+        dispatch::kernel<checksum_kernel_fn>{"simple", 0, &decode_adler32_simple},
+    };
+
+    inline checksum_kernel_fn& selected_crc32c_kernel() noexcept
+    {
+        static checksum_kernel_fn kernel = dispatch::select(crc32c_kernels);
+        return kernel;
+    }
+
+    inline checksum_kernel_fn& selected_adler32_kernel() noexcept
+    {
+        static checksum_kernel_fn kernel = dispatch::select(adler32_kernels);
+        return kernel;
+    }
+
+    template <typename FN_UPDATE>
+    checksum_result decode_with_checksum(std::string_view _input,
+                                         uint8_t* _output,
+                                         uint32_t _state,
+                                         checksum_kernel_fn _kernel,
+                                         FN_UPDATE _update)
+    {
+        while (!_input.empty() && _input.back() == '=')
+            _input.remove_suffix(1);
+
+        auto const mainInputLength = _input.size() & ~size_t(15);
+        size_t outputLength = (mainInputLength / 4) * 3;
+        if (mainInputLength)
+        {
+            _state = _kernel(reinterpret_cast<uint8_t const*>(_input.data()),
+                             mainInputLength,
+                             _output,
+                             _state);
+            _input.remove_prefix(mainInputLength);
+        }
+
+        if (!_input.empty())
+        {
+            auto const tail = _output + outputLength;
+            auto const tailLength = decoder::simple::decode(_input.begin(), _input.end(), tail);
+            _state = _update(_state, tail, tailLength);
+            outputLength += tailLength;
+        }
+
+        return checksum_result{outputLength, _state};
+    }
+}
+
+/// Decodes @p _input into @p _output (see decode(std::string_view, uint8_t*))
+/// and computes the CRC32C (Castagnoli) of the decoded bytes in the same pass.
+///
+/// @param _crc CRC32C of preceding data, allowing incremental computation.
+inline checksum_result decode_with_crc32c(std::string_view _input, uint8_t* _output, uint32_t _crc = 0)
+{
+    auto result = detail::decode_with_checksum(
+        _input,
+        _output,
+        ~_crc,
+        detail::selected_crc32c_kernel(),
+        detail::checksum::simple::crc32c_update);
+    result.checksum = ~result.checksum;
+    return result;
+}
+
+/// Decodes @p _input into @p _output (see decode(std::string_view, uint8_t*))
+/// and computes the Adler-32 of the decoded bytes in the same pass.
+///
+/// @param _adler Adler-32 of preceding data, allowing incremental computation.
+inline checksum_result decode_with_adler32(std::string_view _input, uint8_t* _output, uint32_t _adler = 1)
+{
+    return detail::decode_with_checksum(
+        _input,
+        _output,
+        _adler,
+        detail::selected_adler32_kernel(),
+        detail::checksum::simple::adler32_update);
+}
+
+} // namespace base64
@@ -1,61 +1,254 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include <base64-cpp/detail/compiled.hpp>
+#include <base64-cpp/detail/decode-avx2.hpp>
 #include <base64-cpp/detail/decode-common.hpp>
 #include <base64-cpp/detail/decode-simple.hpp>
 #include <base64-cpp/detail/decode-sse.hpp>
-//#include <base64-cpp/detail/decode-avx.hpp>
+#include <base64-cpp/detail/decode-swar.hpp>
+#include <base64-cpp/detail/dispatch.hpp>
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace base64::detail::decoder
+{
+
+/// Block decoding kernel: decodes @p _size characters (a multiple of 16)
+/// into (_size / 4) * 3 bytes, throwing invalid_input on malformed input.
+using kernel_fn = void (*)(uint8_t const* _input, size_t _size, uint8_t* _output);
+
+/// All decoding kernels, ordered from best to worst.
+inline constexpr std::array kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<kernel_fn>{"avx2", cpu::to_set(cpu::feature::AVX2), &avx2::decode_pshufb_madd},
+    dispatch::kernel<kernel_fn>{"avx2-bmi2", cpu::to_set(cpu::feature::AVX2, cpu::feature::BMI2), &avx2::decode_bmi2_pshufb},
+    dispatch::kernel<kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &sse::decode_pshufb_madd},
+    dispatch::kernel<kernel_fn>{"sse-bmi2", cpu::to_set(cpu::feature::SSE4_1, cpu::feature::BMI2), &sse::decode_bmi2_pshufb},
+    dispatch::kernel<kernel_fn>{"sse-bitmask", cpu::to_set(cpu::feature::SSE4_1), &sse::decode_pshufb_bitmask_madd},
+    dispatch::kernel<kernel_fn>{"sse-aqrit", cpu::to_set(cpu::feature::SSSE3), &sse::decode_aqrit},
+#endif
+    dispatch::kernel<kernel_fn>{"swar", 0, &swar::decode},
+    dispatch::kernel<kernel_fn>{"simple", 0, &simple::decode_blocks},
+};
+
+/// @returns the kernel used by base64::decode(), selected on first use
+///          (or installed by base64::autotune()).
+inline kernel_fn& selected_kernel() noexcept
+{
+    static kernel_fn kernel = dispatch::select(kernels);
+    return kernel;
+}
+
+/// All kernels for decode_mode::trusted, ordered from best to worst.
+/// They translate characters without validating them.
+inline constexpr std::array trusted_kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<kernel_fn>{"avx2", cpu::to_set(cpu::feature::AVX2), &avx2::decode_trusted},
+    dispatch::kernel<kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &sse::decode_trusted},
+#endif
+    dispatch::kernel<kernel_fn>{"swar", 0, &swar::decode_trusted},
+};
+
+inline kernel_fn& selected_trusted_kernel() noexcept
+{
+    static kernel_fn kernel = dispatch::select(trusted_kernels);
+    return kernel;
+}
+
+inline void decode_trusted(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+#if defined(BASE64_CPP_COMPILED)
+    base64_cpp_decode_trusted(_input, _size, _output);
+#else
+    selected_trusted_kernel()(_input, _size, _output);
+#endif
+}
+
+/// Tail kernel: decodes the final (less than 16, unpadded) characters of a
+/// lenient decode(), stopping at the first non-alphabet character.
+/// @returns the number of bytes written.
+using tail_kernel_fn = size_t (*)(uint8_t const* _input, size_t _size, uint8_t* _output);
+
+/// All tail decoding kernels, ordered from best to worst.
+inline constexpr std::array tail_kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<tail_kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &sse::decode_tail},
+#endif
+    dispatch::kernel<tail_kernel_fn>{"simple", 0, &simple::decode_tail},
+};
+
+inline tail_kernel_fn& selected_tail_kernel() noexcept
+{
+    static tail_kernel_fn kernel = dispatch::select(tail_kernels);
+    return kernel;
+}
+
+inline size_t decode_tail(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+#if defined(BASE64_CPP_COMPILED)
+    return base64_cpp_decode_tail(_input, _size, _output);
+#else
+    return selected_tail_kernel()(_input, _size, _output);
+#endif
+}
+
+}
 
 namespace base64
 {
 
+/// Decodes @p _size characters (a multiple of 16) into (_size / 4) * 3 bytes
+/// using the best kernel available on the running CPU.
 inline void decode(uint8_t const* _input, size_t _size, uint8_t* _output)
 {
-    detail::decoder::sse::decode(detail::decoder::sse::lookup_pshufb,
-                                 detail::decoder::sse::pack_madd,
-                                 _input,
-                                 _size,
-                                 _output);
+#if defined(BASE64_CPP_COMPILED)
+    base64_cpp_decode(_input, _size, _output);
+#else
+    detail::decoder::selected_kernel()(_input, _size, _output);
+#endif
 }
 
-inline std::string decode(std::string_view _input)
+namespace detail::decoder
 {
-    while (!_input.empty() && _input.back() == '=')
-        _input.remove_suffix(1);
+    /// Strictly decodes the final block of @p _size characters (a multiple of 4,
+    /// at most 16), including its padding.
+    ///
+    /// The block is staged into a 16 character buffer, where the padding is
+    /// validated and zeroed (with vector compares on x86), decoded by the block kernel,
+    /// and the bytes that correspond to the padding are required to be zero,
+    /// i.e. the leftover bits of the last character.
+    ///
+    /// @returns number of bytes written.
+    inline size_t decode_tail_strict(uint8_t const* _input, size_t _size, uint8_t* _output)
+    {
+        alignas(16) uint8_t block[16];
+        std::memset(block, 'A', sizeof(block));
+        std::memcpy(block, _input, _size);
 
-    std::string output;
-    output.resize((3 * _input.size()) / 4);
+#if defined(BASE64_CPP_X86)
+        __m128i chars = _mm_load_si128(reinterpret_cast<__m128i const*>(block));
+        auto const padding = sse::strip_padding_strict(chars, _size);
+        _mm_store_si128(reinterpret_cast<__m128i*>(block), chars);
+#else
+        auto const padding = simple::strip_padding_strict(block, _size);
+#endif
+
+        uint8_t bytes[12];
+        try
+        {
+            base64::decode(block, sizeof(block), bytes);
+        }
+        catch (invalid_input const& e)
+        {
+            // Chars past _size are the 'A' fill and never invalid.
+            throw invalid_input{e.offset, _input[e.offset]};
+        }
 
-    auto const remainderLength = _input.size() & 15;
-    auto const mainInputLength = _input.size() & ~15;
-    size_t outputLength = (mainInputLength / 4) * 3;
-    size_t decodedCount = ((outputLength + 3) / 4) * 3;
-    if (_input.size() >= 16)
+        auto const outputLength = (_size / 4) * 3 - padding;
+        for (size_t i = outputLength; i < outputLength + padding; ++i)
+            if (bytes[i] != 0)
+                throw invalid_input{_size - padding - 1, _input[_size - padding - 1]};
+
+        std::memcpy(_output, bytes, outputLength);
+        return outputLength;
+    }
+}
+
+/// Decodes @p _input into @p _output.
+///
+/// With decode_mode::lenient (the default), any number of trailing '=' is
+/// accepted and non-zero bits of an incomplete final group are ignored.
+///
+/// With decode_mode::strict, only canonical encodings (RFC 4648, section 3.5)
+/// are accepted: the input length must be a multiple of 4, padding must be
+/// complete and only at the end, and the unused bits of the last character
+/// must be zero. Violations throw invalid_input with the offending offset.
+///
+/// With decode_mode::trusted, whole blocks of 16 characters are translated
+/// without any validation, for input the caller has encoded itself (cache
+/// entries, internal messages). Trailing '=' are handled as in lenient mode.
+/// The result of decoding invalid input is unspecified, but never reads or
+/// writes out of bounds.
+///
+/// @p _output must provide room for at least (3 * _input.size()) / 4 bytes.
+///
+/// @returns number of bytes written.
+template <decode_mode Mode = decode_mode::lenient>
+size_t decode(std::string_view _input, uint8_t* _output)
+{
+    if constexpr (Mode == decode_mode::strict)
     {
-        decode(reinterpret_cast<uint8_t const*>(_input.data()),
-               mainInputLength,
-               reinterpret_cast<uint8_t*>(output.data()));
-        _input.remove_prefix(mainInputLength);
+        auto const input = reinterpret_cast<uint8_t const*>(_input.data());
+        if (_input.size() % 4)
+            throw detail::decoder::invalid_input{_input.size() - 1, input[_input.size() - 1]};
+        if (_input.empty())
+            return 0;
+
+        // everything but the final (padded) block of 4 to 16 characters
+        auto const mainInputLength = (_input.size() - 1) & ~size_t(15);
+        auto const mainOutputLength = (mainInputLength / 4) * 3;
+        if (mainInputLength)
+            decode(input, mainInputLength, _output);
+
+        try
+        {
+            return mainOutputLength + detail::decoder::decode_tail_strict(input + mainInputLength,
+                                                                          _input.size() - mainInputLength,
+                                                                          _output + mainOutputLength);
+        }
+        catch (detail::decoder::invalid_input const& e)
+        {
+            throw detail::decoder::invalid_input{mainInputLength + e.offset, e.byte};
+        }
     }
+    else
+    {
+        while (!_input.empty() && _input.back() == '=')
+            _input.remove_suffix(1);
 
-    // abcd|e
-    // 4    1
-    //
-    // abcd|efgh|ijk
-    //  4   4     3
+        auto const mainInputLength = _input.size() & ~size_t(15);
+        size_t outputLength = (mainInputLength / 4) * 3;
+        if (mainInputLength)
+        {
+            if constexpr (Mode == decode_mode::trusted)
+                detail::decoder::decode_trusted(reinterpret_cast<uint8_t const*>(_input.data()), mainInputLength, _output);
+            else
+                decode(reinterpret_cast<uint8_t const*>(_input.data()), mainInputLength, _output);
+            _input.remove_prefix(mainInputLength);
+        }
 
-    if (remainderLength)
+        // abcd|e
+        // 4    1
+        //
+        // abcd|efgh|ijk
+        //  4   4     3
+
+        if (!_input.empty())
+            outputLength += detail::decoder::decode_tail(reinterpret_cast<uint8_t const*>(_input.data()),
+                                                         _input.size(),
+                                                         _output + outputLength);
+
+        return outputLength;
+    }
+}
+
+template <decode_mode Mode = decode_mode::lenient>
+std::string decode(std::string_view _input)
+{
+    // decode into the stack rather than into a zero-filled, over-sized string
+    if (_input.size() <= detail::decoder::small_input_size)
     {
-        auto const outputBegin = output.data() + outputLength;
-        auto const finalFragmentLength = detail::decoder::simple::decode(
-            _input.data(),
-            _input.data() + _input.size(),
-            outputBegin
-        );
-        outputLength += finalFragmentLength;
-        output.resize(outputLength);
+        uint8_t bytes[(3 * detail::decoder::small_input_size) / 4];
+        return std::string(reinterpret_cast<char const*>(bytes), decode<Mode>(_input, bytes));
     }
 
+    std::string output;
+    output.resize((3 * _input.size()) / 4);
+    output.resize(decode<Mode>(_input, reinterpret_cast<uint8_t*>(output.data())));
     return output;
 }
 
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "base16-simple.hpp"
+#include "decode-common.hpp"
+#include "target.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(BASE64_CPP_X86)
+
+#include <immintrin.h>
+
+namespace base16::detail::avx2
+{
+
+using base64::detail::decoder::invalid_input;
+
+#define packed_byte256(b) _mm256_set1_epi8(static_cast<char>(b))
+
+// {{{ decode
+
+/// 256-bit version of sse::lookup_pshufb; the LUTs are replicated into both lanes.
+BASE64_CPP_TARGET_AVX2 inline __m256i lookup_pshufb(__m256i const _input)
+{
+    __m256i const higher_nibble = _mm256_and_si256(_mm256_srli_epi32(_input, 4), packed_byte256(0x0f));
+    __m256i const lower_nibble  = _mm256_and_si256(_input, packed_byte256(0x0f));
+
+    const char linv = 16;
+    const char hinv = -1;
+
+    __m256i const lower_bound_LUT = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        linv, linv, linv, 0,    1,    linv, 1,    linv,
+        linv, linv, linv, linv, linv, linv, linv, linv
+    ));
+
+    __m256i const upper_bound_LUT = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        hinv, hinv, hinv, 9,    6,    hinv, 6,    hinv,
+        hinv, hinv, hinv, hinv, hinv, hinv, hinv, hinv
+    ));
+
+    __m256i const shift_LUT = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        0, 0, 0, 0, 9, 0, 9, 0,
+        0, 0, 0, 0, 0, 0, 0, 0
+    ));
+
+    __m256i const below = _mm256_cmpgt_epi8(_mm256_shuffle_epi8(lower_bound_LUT, higher_nibble), lower_nibble);
+    __m256i const above = _mm256_cmpgt_epi8(lower_nibble, _mm256_shuffle_epi8(upper_bound_LUT, higher_nibble));
+
+    auto const mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(below, above)));
+    if (mask)
+        throw invalid_input{static_cast<size_t>(__builtin_ctz(mask)), 0};
+
+    return _mm256_add_epi8(lower_nibble, _mm256_shuffle_epi8(shift_LUT, higher_nibble));
+}
+
+BASE64_CPP_TARGET_AVX2 inline __m256i pack_madd(__m256i const _values)
+{
+    return _mm256_maddubs_epi16(_values, _mm256_set1_epi16(0x0110));
+}
+
+/// Decodes @p _size hex digits (an even number) into _size / 2 bytes,
+/// 64 digits per iteration, and the remainder with the scalar decoder.
+template <typename FN_LOOKUP>
+BASE64_CPP_TARGET_AVX2 void decode(FN_LOOKUP _lookup, uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    auto const lookupAt = [&](size_t _offset) BASE64_CPP_TARGET_AVX2 -> __m256i {
+        __m256i const in = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(_input + _offset));
+        try
+        {
+            return _lookup(in);
+        }
+        catch (invalid_input const& e)
+        {
+            throw invalid_input{_offset + e.offset, _input[_offset + e.offset]};
+        }
+    };
+
+    size_t i = 0;
+    for (; i + 64 <= _size; i += 64)
+    {
+        __m256i const lo = pack_madd(lookupAt(i));
+        __m256i const hi = pack_madd(lookupAt(i + 32));
+
+        // packus works per 128-bit lane: [lo.0 hi.0 | lo.1 hi.1] -> [lo.0 lo.1 | hi.0 hi.1]
+        __m256i const packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(_output + i / 2), packed);
+    }
+
+    try
+    {
+        simple::decode(_input + i, _size - i, _output + i / 2);
+    }
+    catch (invalid_input const& e)
+    {
+        throw invalid_input{i + e.offset, e.byte};
+    }
+}
+
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_AVX2 inline void decode_pshufb(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    decode(lookup_pshufb, _input, _size, _output);
+}
+
+// }}}
+// {{{ encode
+
+/// Encodes @p _size bytes into 2 * _size lower-case hex digits,
+/// 32 bytes per iteration, and the remainder with the scalar encoder.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_AVX2 inline void encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    __m256i const digits_LUT = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        '0', '1', '2', '3', '4', '5', '6', '7',
+        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+    ));
+
+    size_t i = 0;
+    for (; i + 32 <= _size; i += 32)
+    {
+        __m256i const in = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(_input + i));
+
+        __m256i const higher_nibble = _mm256_and_si256(_mm256_srli_epi32(in, 4), packed_byte256(0x0f));
+        __m256i const lower_nibble  = _mm256_and_si256(in, packed_byte256(0x0f));
+
+        __m256i const hi = _mm256_shuffle_epi8(digits_LUT, higher_nibble);
+        __m256i const lo = _mm256_shuffle_epi8(digits_LUT, lower_nibble);
+
+        // unpack works per 128-bit lane: a = [0..7 | 16..23], b = [8..15 | 24..31]
+        __m256i const a = _mm256_unpacklo_epi8(hi, lo);
+        __m256i const b = _mm256_unpackhi_epi8(hi, lo);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(_output + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(_output + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+
+    simple::encode(_input + i, _size - i, _output + 2 * i);
+}
+
+// }}}
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "decode-common.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+namespace base16::detail::simple
+{
+
+using base64::detail::decoder::invalid_input;
+
+auto static const inline digits = std::string_view{"0123456789abcdef"};
+
+constexpr inline uint8_t invalid = 0xff;
+
+constexpr std::array<uint8_t, 256> make_value_table() noexcept
+{
+    std::array<uint8_t, 256> table {};
+    for (auto& value: table)
+        value = invalid;
+    for (uint8_t i = 0; i < 10; ++i)
+        table['0' + i] = i;
+    for (uint8_t i = 0; i < 6; ++i)
+    {
+        table['a' + i] = uint8_t(10 + i);
+        table['A' + i] = uint8_t(10 + i);
+    }
+    return table;
+}
+
+/// Maps each (case-insensitive) hex digit to its value and anything else to invalid.
+constexpr inline std::array<uint8_t, 256> valueTable = make_value_table();
+
+/// Decodes @p _size hex digits (an even number) into _size / 2 bytes,
+/// throwing invalid_input on the first non-hex character.
+inline void decode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    for (size_t i = 0; i + 1 < _size; i += 2)
+    {
+        uint8_t const hi = valueTable[_input[i]];
+        uint8_t const lo = valueTable[_input[i + 1]];
+
+        if ((hi | lo) == invalid)
+        {
+            auto const offset = hi == invalid ? i : i + 1;
+            throw invalid_input{offset, _input[offset]};
+        }
+
+        *_output++ = static_cast<uint8_t>(hi << 4 | lo);
+    }
+}
+
+/// Encodes @p _size bytes into 2 * _size lower-case hex digits.
+inline void encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    for (size_t i = 0; i < _size; ++i)
+    {
+        *_output++ = static_cast<uint8_t>(digits[_input[i] >> 4]);
+        *_output++ = static_cast<uint8_t>(digits[_input[i] & 0x0f]);
+    }
+}
+
+}
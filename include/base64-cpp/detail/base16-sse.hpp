@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "base16-simple.hpp"
+#include "decode-common.hpp"
+#include "target.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(BASE64_CPP_X86)
+
+#include <immintrin.h>
+
+namespace base16::detail::sse
+{
+
+using base64::detail::decoder::invalid_input;
+
+#define packed_byte(b) _mm_set1_epi8(uint8_t(b))
+
+// {{{ decode
+
+BASE64_CPP_TARGET_SSSE3 inline __m128i lookup_pshufb(__m128i const _input)
+{
+    /*
+    +-----------+--------------+-----------------+-------+
+    | digits    | higher nibble| lower nibble    | value |
+    +===========+==============+=================+=======+
+    | '0' - '9' |      3       |   0 .. 9        | lo    |
+    +-----------+--------------+-----------------+-------+
+    | 'A' - 'F' |      4       |   1 .. 6        | lo + 9|
+    +-----------+--------------+-----------------+-------+
+    | 'a' - 'f' |      6       |   1 .. 6        | lo + 9|
+    +-----------+--------------+-----------------+-------+
+
+    number of operations:
+    - cmp:             2
+    - shift:           1
+    - add:             1
+    - and/or:          3
+    - movemask:        1
+    - pshufb:          3
+    - total:         =11
+    */
+
+    __m128i const higher_nibble = _mm_and_si128(_mm_srli_epi32(_input, 4), packed_byte(0x0f));
+    __m128i const lower_nibble  = _mm_and_si128(_input, packed_byte(0x0f));
+
+    const char linv = 16;
+    const char hinv = -1;
+
+    __m128i const lower_bound_LUT = _mm_setr_epi8(
+        linv, linv, linv, 0,    1,    linv, 1,    linv,
+        linv, linv, linv, linv, linv, linv, linv, linv
+    );
+
+    __m128i const upper_bound_LUT = _mm_setr_epi8(
+        hinv, hinv, hinv, 9,    6,    hinv, 6,    hinv,
+        hinv, hinv, hinv, hinv, hinv, hinv, hinv, hinv
+    );
+
+    __m128i const shift_LUT = _mm_setr_epi8(
+        0, 0, 0, 0, 9, 0, 9, 0,
+        0, 0, 0, 0, 0, 0, 0, 0
+    );
+
+    __m128i const below = _mm_cmplt_epi8(lower_nibble, _mm_shuffle_epi8(lower_bound_LUT, higher_nibble));
+    __m128i const above = _mm_cmpgt_epi8(lower_nibble, _mm_shuffle_epi8(upper_bound_LUT, higher_nibble));
+
+    auto const mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(below, above)));
+    if (mask)
+        throw invalid_input{static_cast<size_t>(__builtin_ctz(mask)), 0};
+
+    return _mm_add_epi8(lower_nibble, _mm_shuffle_epi8(shift_LUT, higher_nibble));
+}
+
+BASE64_CPP_TARGET_SSSE3 inline __m128i pack_madd(__m128i const _values)
+{
+    // input:  packed_word([0000llll|0000hhhh] x 8)
+    // result: packed_word([00000000|hhhhllll] x 8)
+    return _mm_maddubs_epi16(_values, _mm_set1_epi16(0x0110));
+}
+
+/// Decodes @p _size hex digits (an even number) into _size / 2 bytes,
+/// 32 digits per iteration, and the remainder with the scalar decoder.
+template <typename FN_LOOKUP>
+BASE64_CPP_TARGET_SSSE3 void decode(FN_LOOKUP _lookup, uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    auto const lookupAt = [&](size_t _offset) BASE64_CPP_TARGET_SSSE3 -> __m128i {
+        __m128i const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + _offset));
+        try
+        {
+            return _lookup(in);
+        }
+        catch (invalid_input const& e)
+        {
+            throw invalid_input{_offset + e.offset, _input[_offset + e.offset]};
+        }
+    };
+
+    size_t i = 0;
+    for (; i + 32 <= _size; i += 32)
+    {
+        __m128i const lo = pack_madd(lookupAt(i));
+        __m128i const hi = pack_madd(lookupAt(i + 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(_output + i / 2), _mm_packus_epi16(lo, hi));
+    }
+
+    try
+    {
+        simple::decode(_input + i, _size - i, _output + i / 2);
+    }
+    catch (invalid_input const& e)
+    {
+        throw invalid_input{i + e.offset, e.byte};
+    }
+}
+
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 inline void decode_pshufb(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    decode(lookup_pshufb, _input, _size, _output);
+}
+
+// }}}
+// {{{ encode
+
+/// Encodes @p _size bytes into 2 * _size lower-case hex digits,
+/// 16 bytes per iteration, and the remainder with the scalar encoder.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 inline void encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    __m128i const digits_LUT = _mm_setr_epi8(
+        '0', '1', '2', '3', '4', '5', '6', '7',
+        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+    );
+
+    size_t i = 0;
+    for (; i + 16 <= _size; i += 16)
+    {
+        __m128i const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + i));
+
+        __m128i const higher_nibble = _mm_and_si128(_mm_srli_epi32(in, 4), packed_byte(0x0f));
+        __m128i const lower_nibble  = _mm_and_si128(in, packed_byte(0x0f));
+
+        __m128i const hi = _mm_shuffle_epi8(digits_LUT, higher_nibble);
+        __m128i const lo = _mm_shuffle_epi8(digits_LUT, lower_nibble);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(_output + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(_output + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+
+    simple::encode(_input + i, _size - i, _output + 2 * i);
+}
+
+// }}}
+
+}
+
+#endif
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "decode-common.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+namespace base32
+{
+
+/// The base32 alphabets defined by RFC 4648.
+enum class alphabet
+{
+    standard,     //!< RFC 4648 section 6: A-Z, 2-7
+    extended_hex, //!< RFC 4648 section 7: 0-9, A-V
+};
+
+}
+
+namespace base32::detail::simple
+{
+
+using base64::detail::decoder::invalid_input;
+
+template <alphabet A>
+constexpr std::string_view digits = A == alphabet::standard ? std::string_view{"ABCDEFGHIJKLMNOPQRSTUVWXYZ234567"}
+                                                            : std::string_view{"0123456789ABCDEFGHIJKLMNOPQRSTUV"};
+
+constexpr inline uint8_t invalid = 0xff;
+
+template <alphabet A>
+constexpr std::array<uint8_t, 256> make_value_table() noexcept
+{
+    std::array<uint8_t, 256> table {};
+    for (auto& value: table)
+        value = invalid;
+    for (uint8_t i = 0; i < 32; ++i)
+    {
+        auto const c = static_cast<uint8_t>(digits<A>[i]);
+        table[c] = i;
+        if (c >= 'A' && c <= 'Z')
+            table[c - 'A' + 'a'] = i;
+    }
+    return table;
+}
+
+/// Maps each (case-insensitive) digit of alphabet A to its value and anything else to invalid.
+template <alphabet A>
+constexpr inline std::array<uint8_t, 256> valueTable = make_value_table<A>();
+
+/// @returns the offset of the first invalid character in [_input, _input + _size).
+template <alphabet A>
+size_t find_invalid(uint8_t const* _input, size_t _size) noexcept
+{
+    size_t i = 0;
+    while (i < _size && valueTable<A>[_input[i]] != invalid)
+        ++i;
+    return i;
+}
+
+/// Decodes @p _size characters (a multiple of 8, no padding) into (_size / 8) * 5 bytes,
+/// throwing invalid_input on the first non-alphabet character.
+template <alphabet A>
+void decode_blocks(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    for (size_t i = 0; i < _size; i += 8)
+    {
+        uint64_t bits = 0;
+        uint8_t check = 0;
+        for (size_t k = 0; k < 8; ++k)
+        {
+            auto const value = valueTable<A>[_input[i + k]];
+            check |= value;
+            bits = (bits << 5) | (value & 0x1f);
+        }
+
+        if (check == invalid)
+        {
+            auto const offset = i + find_invalid<A>(_input + i, 8);
+            throw invalid_input{offset, _input[offset]};
+        }
+
+        for (int k = 4; k >= 0; --k)
+            *_output++ = static_cast<uint8_t>(bits >> (8 * k));
+    }
+}
+
+/// Decodes the final, incomplete group of @p _size characters (without padding).
+///
+/// Valid group sizes are 0, 2, 4, 5 and 7 characters, decoding into 0 to 4 bytes.
+///
+/// @returns number of bytes written.
+template <alphabet A>
+size_t decode_tail(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    if (auto const offset = find_invalid<A>(_input, _size); offset != _size)
+        throw invalid_input{offset, _input[offset]};
+
+    if (_size == 1 || _size == 3 || _size == 6 || _size >= 8)
+        throw invalid_input{_size ? _size - 1 : 0, _size ? _input[_size - 1] : uint8_t(0)};
+
+    uint64_t bits = 0;
+    for (size_t k = 0; k < _size; ++k)
+        bits = (bits << 5) | valueTable<A>[_input[k]];
+
+    auto const byteCount = (_size * 5) / 8;
+    bits >>= (_size * 5) % 8; // drop the unused trailing bits
+    for (size_t k = 0; k < byteCount; ++k)
+        _output[k] = static_cast<uint8_t>(bits >> (8 * (byteCount - 1 - k)));
+
+    return byteCount;
+}
+
+/// Encodes @p _size bytes into ((_size + 4) / 5) * 8 characters, including '=' padding.
+template <alphabet A>
+void encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    while (_size)
+    {
+        auto const n = _size < 5 ? _size : size_t(5);
+
+        uint64_t bits = 0;
+        for (size_t k = 0; k < 5; ++k)
+            bits = (bits << 8) | (k < n ? _input[k] : 0);
+
+        // number of characters carrying data for n bytes: 2, 4, 5, 7, 8
+        auto const charCount = (n * 8 + 4) / 5;
+        for (size_t k = 0; k < 8; ++k)
+            *_output++ = k < charCount ? static_cast<uint8_t>(digits<A>[(bits >> (35 - 5 * k)) & 0x1f]) : '=';
+
+        _input += n;
+        _size -= n;
+    }
+}
+
+}
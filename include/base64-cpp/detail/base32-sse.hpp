@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "base32-simple.hpp"
+#include "decode-common.hpp"
+#include "target.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(BASE64_CPP_X86)
+
+#include <immintrin.h>
+
+namespace base32::detail::sse
+{
+
+using base64::detail::decoder::invalid_input;
+
+#define packed_byte(b) _mm_set1_epi8(uint8_t(b))
+#define packed_dword(x) _mm_set1_epi32(x)
+
+// {{{ lookup
+
+template <alphabet A>
+BASE64_CPP_TARGET_SSSE3 __m128i lookup_pshufb(__m128i const _input)
+{
+    /*
+    standard:
+    +-----------+---------------+--------------+-----------+
+    | digits    | higher nibble | lower nibble | value     |
+    +===========+===============+==============+===========+
+    | '2' - '7' |       3       |    2 .. 7    | lo + 24   |
+    | 'A' - 'O' |     4 (6)     |    1 .. 15   | lo - 1    |
+    | 'P' - 'Z' |     5 (7)     |    0 .. 10   | lo + 15   |
+    +-----------+---------------+--------------+-----------+
+
+    extended hex:
+    +-----------+---------------+--------------+-----------+
+    | '0' - '9' |       3       |    0 .. 9    | lo        |
+    | 'A' - 'O' |     4 (6)     |    1 .. 15   | lo + 9    |
+    | 'P' - 'V' |     5 (7)     |    0 .. 6    | lo + 25   |
+    +-----------+---------------+--------------+-----------+
+
+    Lower case letters (higher nibble in parenthesis) decode like upper case ones.
+
+    number of operations:
+    - cmp:             2
+    - shift:           1
+    - add:             1
+    - and/or:          3
+    - movemask:        1
+    - pshufb:          3
+    - total:         =11
+    */
+
+    constexpr bool standard = A == alphabet::standard;
+
+    __m128i const higher_nibble = _mm_and_si128(_mm_srli_epi32(_input, 4), packed_byte(0x0f));
+    __m128i const lower_nibble  = _mm_and_si128(_input, packed_byte(0x0f));
+
+    const char linv = 16;
+    const char hinv = -1;
+
+    __m128i const lower_bound_LUT = _mm_setr_epi8(
+        linv, linv, linv, standard ? 2 : 0, 1, 0, 1, 0,
+        linv, linv, linv, linv, linv, linv, linv, linv
+    );
+
+    __m128i const upper_bound_LUT = _mm_setr_epi8(
+        hinv, hinv, hinv, standard ? 7 : 9, 15, standard ? 10 : 6, 15, standard ? 10 : 6,
+        hinv, hinv, hinv, hinv, hinv, hinv, hinv, hinv
+    );
+
+    __m128i const shift_LUT = _mm_setr_epi8(
+        0, 0, 0, standard ? 24 : 0, standard ? -1 : 9, standard ? 15 : 25, standard ? -1 : 9, standard ? 15 : 25,
+        0, 0, 0, 0, 0, 0, 0, 0
+    );
+
+    __m128i const below = _mm_cmplt_epi8(lower_nibble, _mm_shuffle_epi8(lower_bound_LUT, higher_nibble));
+    __m128i const above = _mm_cmpgt_epi8(lower_nibble, _mm_shuffle_epi8(upper_bound_LUT, higher_nibble));
+
+    auto const mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(below, above)));
+    if (mask)
+        throw invalid_input{static_cast<size_t>(__builtin_ctz(mask)), 0};
+
+    return _mm_add_epi8(lower_nibble, _mm_shuffle_epi8(shift_LUT, higher_nibble));
+}
+
+// }}}
+// {{{ pack
+
+BASE64_CPP_TARGET_SSSE3 inline __m128i pack_madd(__m128i const _values)
+{
+    // input:  packed_byte([000hhhhh|000ggggg|...|000bbbbb|000aaaaa]) (two groups of 8)
+
+    // t0:     packed_word([000000aa|aaabbbbb] x 8)
+    __m128i const t0 = _mm_maddubs_epi16(_values, _mm_set1_epi16(0x0120));
+
+    // t1:     packed_dword([0000aaaa|abbbbbcc|cccddddd] x 4)
+    __m128i const t1 = _mm_madd_epi16(t0, packed_dword(0x00010400));
+
+    // t2:     packed_qword([40 bit: abcd efgh] x 2)
+    __m128i const t2 = _mm_or_si128(
+                        _mm_slli_epi64(_mm_and_si128(t1, _mm_set_epi32(0, -1, 0, -1)), 20),
+                        _mm_srli_epi64(t1, 32)
+                       );
+
+    // result: 5 + 5 bytes in output (big endian) order
+    return _mm_shuffle_epi8(t2, _mm_setr_epi8(
+        4,  3,  2,  1,  0,
+       12, 11, 10,  9,  8,
+       char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff)
+    ));
+}
+
+// }}}
+// {{{ decode
+
+/// Decodes @p _size characters (a multiple of 8, no padding) into (_size / 8) * 5 bytes,
+/// 16 characters per iteration, and a trailing group of 8 with the scalar decoder.
+template <alphabet A, typename FN_LOOKUP, typename FN_PACK>
+BASE64_CPP_TARGET_SSSE3 void decode(FN_LOOKUP _lookup, FN_PACK _pack, uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    assert(_size % 8 == 0);
+
+    uint8_t* out = _output;
+    size_t i = 0;
+
+    for (; i + 16 <= _size; i += 16)
+    {
+        __m128i const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + i));
+        __m128i values;
+
+        try
+        {
+            values = _lookup(in);
+        }
+        catch (invalid_input const& e)
+        {
+            const auto shift = e.offset;
+            throw invalid_input{i + shift, _input[i + shift]};
+        }
+
+        __m128i const packed = _pack(values);
+
+        // Only a following whole block covers the 6 bytes past the 10 decoded
+        // ones, a trailing group of 8 does not (it decodes to 5 bytes).
+        if (i + 32 <= _size)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+        else
+        {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), packed);
+            auto const high = static_cast<uint16_t>(_mm_extract_epi16(packed, 4));
+            std::memcpy(out + 8, &high, 2);
+        }
+        out += 10;
+    }
+
+    try
+    {
+        simple::decode_blocks<A>(_input + i, _size - i, out);
+    }
+    catch (invalid_input const& e)
+    {
+        throw invalid_input{i + e.offset, e.byte};
+    }
+}
+
+template <alphabet A>
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 void decode_pshufb_madd(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    decode<A>(lookup_pshufb<A>, pack_madd, _input, _size, _output);
+}
+
+// }}}
+// {{{ unpack
+
+BASE64_CPP_TARGET_SSSE3 inline __m128i unpack_mul(__m128i const _input, int _group)
+{
+    // Every 5-bit index k of a group lies within the big endian byte pair
+    // (b[j], b[j+1]) with j = 5k / 8, starting at bit 5k % 8 from the top.
+    // Put each pair into its own word, then shift right by 11 - (5k % 8)
+    // through mulhi by 2^(5 + 5k % 8).
+    __m128i const pairs = _mm_shuffle_epi8(_input, _group == 0 ? _mm_setr_epi8(
+        1, 0,  1, 0,  2, 1,  2, 1,  3, 2,  4, 3,  4, 3,  5, 4
+    ) : _mm_setr_epi8(
+        6, 5,  6, 5,  7, 6,  7, 6,  8, 7,  9, 8,  9, 8, 10, 9
+    ));
+
+    __m128i const shifted = _mm_mulhi_epu16(pairs, _mm_setr_epi16(
+        1 << 5, 1 << 10, 1 << 7, 1 << 12, 1 << 9, 1 << 6, 1 << 11, 1 << 8
+    ));
+
+    // result: packed_word([00000000|000iiiii] x 8)
+    return _mm_and_si128(shifted, _mm_set1_epi16(0x1f));
+}
+
+// }}}
+// {{{ translate
+
+template <alphabet A>
+__m128i translate(__m128i const _indices)
+{
+    // standard:     0..25 -> 'A'.., 26..31 -> '2'..
+    // extended hex: 0..9  -> '0'.., 10..31 -> 'A'..
+    constexpr char threshold = A == alphabet::standard ? 25 : 9;
+    constexpr char lowOffset = A == alphabet::standard ? 'A' : '0';
+    constexpr char highOffset = A == alphabet::standard ? '2' - 26 : 'A' - 10;
+
+    __m128i const high = _mm_cmpgt_epi8(_indices, packed_byte(threshold));
+    __m128i const offset = _mm_add_epi8(packed_byte(lowOffset), _mm_and_si128(high, packed_byte(highOffset - lowOffset)));
+    return _mm_add_epi8(_indices, offset);
+}
+
+// }}}
+// {{{ encode
+
+/// Encodes @p _size bytes (a multiple of 5) into (_size / 5) * 8 characters,
+/// 10 bytes per iteration, and a trailing group of 5 with the scalar encoder.
+template <alphabet A>
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 void encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    assert(_size % 5 == 0);
+
+    uint8_t* out = _output;
+    size_t i = 0;
+
+    auto const encodeBlock = [&](__m128i _in) BASE64_CPP_TARGET_SSSE3 {
+        __m128i const indices = _mm_packus_epi16(unpack_mul(_in, 0), unpack_mul(_in, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), translate<A>(indices));
+        out += 16;
+    };
+
+    for (; i + 16 <= _size; i += 10)
+        encodeBlock(_mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + i)));
+
+    if (i + 10 <= _size)
+    {
+        alignas(16) uint8_t tail[16] = {};
+        std::memcpy(tail, _input + i, 10);
+        encodeBlock(_mm_load_si128(reinterpret_cast<__m128i const*>(tail)));
+        i += 10;
+    }
+
+    simple::encode<A>(_input + i, _size - i, out);
+}
+
+// }}}
+
+}
+
+#endif
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+namespace base64::detail::checksum::simple
+{
+
+// {{{ CRC32C (Castagnoli)
+
+constexpr inline uint32_t crc32c_polynomial = 0x82f63b78; // reflected
+
+constexpr std::array<uint32_t, 256> make_crc32c_table() noexcept
+{
+    std::array<uint32_t, 256> table {};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i;
+        for (int k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ ((crc & 1) ? crc32c_polynomial : 0);
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr inline std::array<uint32_t, 256> crc32c_table = make_crc32c_table();
+
+/// Updates the raw (non-inverted) CRC32C state @p _crc with @p _size bytes at @p _data.
+inline uint32_t crc32c_update(uint32_t _crc, uint8_t const* _data, size_t _size) noexcept
+{
+    for (size_t i = 0; i < _size; ++i)
+        _crc = crc32c_table[(_crc ^ _data[i]) & 0xff] ^ (_crc >> 8);
+    return _crc;
+}
+
+// }}}
+// {{{ Adler-32
+
+constexpr inline uint32_t adler32_base = 65521;
+
+/// Largest n such that 255n(n+1)/2 + (n+1)(adler32_base-1) <= 2^32-1,
+/// i.e. the number of bytes that can be summed up before reducing.
+constexpr inline size_t adler32_nmax = 5552;
+
+inline uint32_t adler32_update(uint32_t _adler, uint8_t const* _data, size_t _size) noexcept
+{
+    uint32_t a = _adler & 0xffff;
+    uint32_t b = _adler >> 16;
+
+    while (_size)
+    {
+        auto const n = _size < adler32_nmax ? _size : adler32_nmax;
+        for (size_t i = 0; i < n; ++i)
+        {
+            a += _data[i];
+            b += a;
+        }
+        a %= adler32_base;
+        b %= adler32_base;
+        _data += n;
+        _size -= n;
+    }
+
+    return (b << 16) | a;
+}
+
+// }}}
+
+}
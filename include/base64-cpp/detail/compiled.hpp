@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+// Entry points of the compiled library (CMake target base64-cpp::compiled).
+//
+// When BASE64_CPP_COMPILED is defined, the public block functions forward to
+// these symbols instead of dispatching inline, so that the kernels are
+// compiled once into the library rather than into every translation unit.
+// On ELF platforms they are GNU ifuncs, bound to the best kernel at load time.
+
+#if defined(BASE64_CPP_COMPILED)
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C"
+{
+    void base64_cpp_decode(uint8_t const* _input, size_t _size, uint8_t* _output);
+    void base64_cpp_decode_trusted(uint8_t const* _input, size_t _size, uint8_t* _output);
+    size_t base64_cpp_decode_tail(uint8_t const* _input, size_t _size, uint8_t* _output);
+    void base64_cpp_encode(uint8_t const* _input, size_t _size, uint8_t* _output);
+    void base64_cpp_base16_decode(uint8_t const* _input, size_t _size, uint8_t* _output);
+    void base64_cpp_base16_encode(uint8_t const* _input, size_t _size, uint8_t* _output);
+}
+
+#endif
@@ -3,13 +3,19 @@
 
 #include <array>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <limits>
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <utility>
 
-#include <immintrin.h>
-#include <cpuid.h>
+#include "target.hpp"
+
+#if defined(BASE64_CPP_X86)
+    #include <cpuid.h>
+#endif
 
 namespace base64::detail::cpu
 {
@@ -18,46 +24,128 @@ enum class feature
 {
     SSE2 = 0,
     SSE3,
+    SSSE3,
     SSE4_1,
     SSE4_2,
     AVX,
-    AVX2
+    AVX2,
+    BMI2
 };
 
-std::string_view to_string(feature _f)
+inline std::string_view to_string(feature _f)
 {
-    auto constexpr names = std::array<std::string_view, 6>{
+    auto constexpr names = std::array<std::string_view, 8>{
         "SSE2",
         "SSE3",
+        "SSSE3",
         "SSE4.1",
         "SSE4.2",
         "AVX",
-        "AVX2"
+        "AVX2",
+        "BMI2"
     };
     return names.at(static_cast<size_t>(_f));
 }
 
 inline bool is_available(feature _feature) noexcept
 {
+#if !defined(BASE64_CPP_X86)
+    (void) _feature;
+    return false;
+#else
     using namespace std;
 
     enum class reg : uint8_t { eax, ebx, ecx, edx };
-    constexpr auto mappings = array<std::tuple<feature, reg, unsigned>, 6> {
-        tuple{feature::SSE2,   reg::edx, bit_SSE2},
-        tuple{feature::SSE3,   reg::ecx, bit_SSE3},
-        tuple{feature::SSE4_1, reg::ecx, bit_SSE4_1},
-        tuple{feature::SSE4_2, reg::ecx, bit_SSE4_2},
-        tuple{feature::AVX,    reg::ecx, bit_AVX},
-        tuple{feature::AVX2,   reg::ebx, bit_AVX2},
+    constexpr auto mappings = array<std::tuple<feature, unsigned, reg, unsigned>, 8> {
+        tuple{feature::SSE2,   1, reg::edx, bit_SSE2},
+        tuple{feature::SSE3,   1, reg::ecx, bit_SSE3},
+        tuple{feature::SSSE3,  1, reg::ecx, bit_SSSE3},
+        tuple{feature::SSE4_1, 1, reg::ecx, bit_SSE4_1},
+        tuple{feature::SSE4_2, 1, reg::ecx, bit_SSE4_2},
+        tuple{feature::AVX,    1, reg::ecx, bit_AVX},
+        tuple{feature::AVX2,   7, reg::ebx, bit_AVX2},
+        tuple{feature::BMI2,   7, reg::ebx, bit_BMI2},
     };
 
+    assert(           get<0>(mappings[static_cast<uint8_t>(_feature)]) == _feature);
+    auto const leaf = get<1>(mappings[static_cast<uint8_t>(_feature)]);
+    auto const reg  = get<2>(mappings[static_cast<uint8_t>(_feature)]);
+    auto const bit  = get<3>(mappings[static_cast<uint8_t>(_feature)]);
+
     auto regs = array<unsigned, 4>{0, 0, 0, 0};
-    __get_cpuid(1, &regs[0], &regs[1], &regs[2], &regs[3]);
+    if (!__get_cpuid_count(leaf, 0, &regs[0], &regs[1], &regs[2], &regs[3]))
+        return false;
+
+    if (!(regs[static_cast<uint8_t>(reg)] & bit))
+        return false;
+
+    if (_feature == feature::AVX || _feature == feature::AVX2)
+    {
+        // The OS must also save/restore the YMM registers (XCR0 bits 1 and 2).
+        auto leaf1 = array<unsigned, 4>{0, 0, 0, 0};
+        __get_cpuid(1, &leaf1[0], &leaf1[1], &leaf1[2], &leaf1[3]);
+        if (!(leaf1[2] & bit_OSXSAVE))
+            return false;
+
+        unsigned xcr0 = 0;
+        unsigned xcr0High = 0;
+        __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+        return (xcr0 & 0x06) == 0x06;
+    }
+
+    return true;
+#endif
+}
+
+/// Bit set of CPU features, one bit per feature.
+using feature_set = uint32_t;
+
+constexpr feature_set to_set(feature _feature) noexcept
+{
+    return feature_set(1) << static_cast<unsigned>(_feature);
+}
+
+template <typename... Features>
+constexpr feature_set to_set(feature _first, Features... _rest) noexcept
+{
+    return to_set(_first) | to_set(_rest...);
+}
+
+/// @returns the set of features supported by the running CPU.
+inline feature_set available_features() noexcept
+{
+    feature_set result = 0;
+    for (unsigned i = 0; i <= static_cast<unsigned>(feature::BMI2); ++i)
+        if (is_available(static_cast<feature>(i)))
+            result |= to_set(static_cast<feature>(i));
+    return result;
+}
+
+/// @returns the processor brand string, e.g. "AMD Ryzen 9 5950X 16-Core Processor",
+///          or an empty string if the CPU does not report one.
+inline std::string model_name()
+{
+#if !defined(BASE64_CPP_X86)
+    return {};
+#else
+    unsigned regs[4] = {0, 0, 0, 0};
+    if (!__get_cpuid(0x80000000, &regs[0], &regs[1], &regs[2], &regs[3]) || regs[0] < 0x80000004)
+        return {};
+
+    char brand[48];
+    for (unsigned leaf = 0; leaf < 3; ++leaf)
+    {
+        __get_cpuid(0x80000002 + leaf, &regs[0], &regs[1], &regs[2], &regs[3]);
+        std::memcpy(brand + 16 * leaf, regs, sizeof(regs));
+    }
 
-    assert(          get<0>(mappings[static_cast<uint8_t>(_feature)]) == _feature);
-    auto const reg = get<1>(mappings[static_cast<uint8_t>(_feature)]);
-    auto const bit = get<2>(mappings[static_cast<uint8_t>(_feature)]);
-    return (regs[static_cast<uint8_t>(reg)] & bit) ? true : false;
+    std::string_view name(brand, strnlen(brand, sizeof(brand)));
+    while (!name.empty() && name.front() == ' ')
+        name.remove_prefix(1);
+    while (!name.empty() && name.back() == ' ')
+        name.remove_suffix(1);
+    return std::string(name);
+#endif
 }
 
 }
@@ -67,7 +155,7 @@ namespace std
     template <>
     struct numeric_limits<base64::detail::cpu::feature> {
         static size_t min() { return 0; }
-        static size_t max() { return 5; }
+        static size_t max() { return 7; }
     };
 }
 
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "decode-common.hpp"
+#include "decode-sse.hpp"
+#include "decode-vector.hpp"
+#include "target.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <cstring>
+
+#if defined(BASE64_CPP_X86)
+
+#include <immintrin.h>
+
+namespace base64::detail::decoder::avx2
+{
+
+// {{{ lookup
+
+/// 256-bit version of sse::lookup_pshufb.
+BASE64_CPP_TARGET_AVX2 inline __m256i lookup_pshufb(__m256i const _input)
+{
+    __m256i result;
+    unsigned invalid = 0;
+    generic::lookup_pshufb_masked<vector::v256>(_input, result, invalid);
+
+    if (invalid)
+        throw invalid_input{static_cast<size_t>(__builtin_ctz(invalid)), 0};
+
+    return result;
+}
+
+/// 256-bit version of sse::lookup_shift.
+BASE64_CPP_TARGET_AVX2 inline __m256i lookup_shift(__m256i const _input)
+{
+    __m256i result;
+    generic::lookup_shift<vector::v256>(_input, result);
+    return result;
+}
+
+// }}}
+// {{{ pack
+
+BASE64_CPP_TARGET_AVX2 inline __m256i pack_madd(__m256i const _values)
+{
+    __m256i result;
+    generic::pack_madd<vector::v256>(_values, result);
+    return result;
+}
+
+// }}}
+// {{{ decode
+
+/// Decodes @p _size characters (a multiple of 16) into (_size / 4) * 3 bytes,
+/// 32 characters per iteration, and a trailing block of 16 with the SSE decoder.
+template <typename FN_LOOKUP, typename FN_PACK>
+BASE64_CPP_TARGET_AVX2 void decode(FN_LOOKUP _lookup, FN_PACK _pack, uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    assert(_size % 16 == 0);
+
+    uint8_t* out = _output;
+    size_t i = 0;
+
+    for (; i + 32 <= _size; i += 32)
+    {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_input + i));
+        __m256i values;
+
+        try
+        {
+            values = _lookup(in);
+        }
+        catch (invalid_input const& e)
+        {
+            const auto shift = e.offset;
+            throw invalid_input{i + shift, _input[i + shift]};
+        }
+
+        // _input:  packed_dword([00dddddd|00cccccc|00bbbbbb|00aaaaaa] x 4)
+        // merged: packed_dword([00000000|ddddddcc|ccccbbbb|bbaaaaaa] x 4)
+
+        const __m256i merged = _pack(values);
+
+        // merged = packed_byte([0XXX|0YYY|0ZZZ|0WWW])
+
+        const __m256i shuf = _mm256_setr_epi8(
+               2,  1,  0,
+               6,  5,  4,
+              10,  9,  8,
+              14, 13, 12,
+              char(0xff), char(0xff), char(0xff), char(0xff),
+               2,  1,  0,
+               6,  5,  4,
+              10,  9,  8,
+              14, 13, 12,
+              char(0xff), char(0xff), char(0xff), char(0xff)
+        );
+
+        const __m256i shuffled = _mm256_shuffle_epi8(merged, shuf);
+
+        // The second store overwrites the 4 garbage bytes of the first one;
+        // the last block must not write past the 24 decoded bytes.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(shuffled));
+        if (i + 32 < _size)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm256_extracti128_si256(shuffled, 1));
+        else
+            sse::store_12(out + 12, _mm256_extracti128_si256(shuffled, 1));
+
+        out += 24;
+    }
+
+    if (i < _size)
+    {
+        try
+        {
+            sse::decode(sse::lookup_pshufb, sse::pack_madd, _input + i, _size - i, out);
+        }
+        catch (invalid_input const& e)
+        {
+            throw invalid_input{i + e.offset, e.byte};
+        }
+    }
+}
+
+/// The default AVX2 kernel (lookup_pshufb + pack_madd), as used by the dispatcher.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_AVX2 inline void decode_pshufb_madd(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    decode(lookup_pshufb, pack_madd, _input, _size, _output);
+}
+
+/// Kernel for decode_mode::trusted (lookup_shift + pack_madd): no validation.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_AVX2 inline void decode_trusted(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    auto const mainSize = _size & ~size_t(31);
+    decode(lookup_shift, pack_madd, _input, mainSize, _output);
+    if (mainSize < _size)
+        sse::decode(sse::lookup_shift, sse::pack_madd, _input + mainSize, _size - mainSize, _output + (mainSize / 4) * 3);
+}
+
+BASE64_CPP_TARGET_AVX2 inline __m256i bswap_si256(const __m256i in)
+{
+    return _mm256_shuffle_epi8(
+        in,
+        _mm256_setr_epi8(
+             3,  2,  1,  0,
+             7,  6,  5,  4,
+            11, 10,  9,  8,
+            15, 14, 13, 12,
+             3,  2,  1,  0,
+             7,  6,  5,  4,
+            11, 10,  9,  8,
+            15, 14, 13, 12
+       )
+    );
+}
+
+template <typename FN>
+BASE64_CPP_TARGET_AVX2_BMI2 void decode_bmi2(FN _lookup, uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    assert(_size % 16 == 0);
+
+    uint8_t* out = _output;
+    size_t i = 0;
+
+    for (; i + 32 <= _size; i += 32)
+    {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_input + i));
+        __m256i values;
+
+        try
+        {
+            values = bswap_si256(_lookup(in));
+        }
+        catch (invalid_input const& e)
+        {
+            const auto shift = e.offset;
+            throw invalid_input{i + shift, _input[i + shift]};
+        }
+
+        // _input:  packed_dword([00dddddd|00cccccc|00bbbbbb|00aaaaaa] x 4)
+        // merged: packed_dword([00000000|ddddddcc|ccccbbbb|bbaaaaaa] x 4)
+
+        const __m128i lane0 = _mm256_castsi256_si128(values);
+        const __m128i lane1 = _mm256_extracti128_si256(values, 1);
+
+        const uint64_t t0 = sse::pack_bytes(static_cast<uint64_t>(_mm_extract_epi64(lane0, 0)));
+        const uint64_t t1 = sse::pack_bytes(static_cast<uint64_t>(_mm_extract_epi64(lane0, 1)));
+        const uint64_t t2 = sse::pack_bytes(static_cast<uint64_t>(_mm_extract_epi64(lane1, 0)));
+        const uint64_t t3 = sse::pack_bytes(static_cast<uint64_t>(_mm_extract_epi64(lane1, 1)));
+
+        const uint64_t q0 = (t1 << (6*8)) | t0;
+        const uint64_t q1 = (t2 << (4*8)) | (t1 >> (2*8));
+        const uint64_t q2 = (t3 << (2*8)) | (t2 >> (4*8));
+        std::memcpy(out + 0*8, &q0, 8);
+        std::memcpy(out + 1*8, &q1, 8);
+        std::memcpy(out + 2*8, &q2, 8);
+        out += 24;
+    }
+
+    if (i < _size)
+    {
+        try
+        {
+            sse::decode_bmi2(sse::lookup_pshufb, _input + i, _size - i, out);
+        }
+        catch (invalid_input const& e)
+        {
+            throw invalid_input{i + e.offset, e.byte};
+        }
+    }
+}
+
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_AVX2_BMI2 inline void decode_bmi2_pshufb(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    decode_bmi2(lookup_pshufb, _input, _size, _output);
+}
+
+// }}}
+
+}
+
+#endif
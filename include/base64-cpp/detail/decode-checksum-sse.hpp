@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "checksum-simple.hpp"
+#include "decode-common.hpp"
+#include "decode-sse.hpp"
+#include "target.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(BASE64_CPP_X86)
+
+#include <immintrin.h>
+
+namespace base64::detail::decoder::sse
+{
+
+// {{{ helper
+
+/// Decode loop that hands every packed block (12 bytes in output order,
+/// upper 4 bytes zero) to @p _fold while it is still held in a register.
+template <typename FN_LOOKUP, typename FN_PACK, typename FN_FOLD>
+BASE64_CPP_TARGET_SSSE3 void decode_fold(FN_LOOKUP _lookup, FN_PACK _pack, FN_FOLD&& _fold, uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    assert(_size % 16 == 0);
+
+    uint8_t* out = _output;
+
+    __m128i const shuf = _mm_setr_epi8(
+            2,  1,  0,
+            6,  5,  4,
+           10,  9,  8,
+           14, 13, 12,
+          char(0xff), char(0xff), char(0xff), char(0xff)
+    );
+
+    for (size_t i = 0; i < _size; i += 16)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + i));
+        __m128i values;
+
+        try
+        {
+            values = _lookup(in);
+        }
+        catch (invalid_input const& e)
+        {
+            const auto shift = e.offset;
+            throw invalid_input{i + shift, _input[i + shift]};
+        }
+
+        __m128i const shuffled = _mm_shuffle_epi8(_pack(values), shuf);
+
+        _fold(shuffled);
+
+        if (i + 16 < _size)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), shuffled);
+        else
+            store_12(out, shuffled);
+        out += 12;
+    }
+}
+
+inline uint64_t hsum_epu32(__m128i const _values)
+{
+    alignas(16) uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _values);
+    return uint64_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+}
+
+// }}}
+// {{{ decode + CRC32C
+
+/// Folds the 12 bytes of @p _block into the raw CRC32C state @p _crc via the lookup table.
+inline uint32_t crc32c_block_table(uint32_t _crc, __m128i const _block)
+{
+    alignas(16) uint8_t bytes[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(bytes), _block);
+    return checksum::simple::crc32c_update(_crc, bytes, 12);
+}
+
+/// Folds the 12 bytes of @p _block into the raw CRC32C state @p _crc,
+/// feeding the crc32 instruction straight from the register they were packed in.
+BASE64_CPP_TARGET_SSE42 inline uint32_t crc32c_block_sse42(uint32_t _crc, __m128i const _block)
+{
+    auto const lo = static_cast<uint64_t>(_mm_cvtsi128_si64(_block));
+    auto const hi = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(_block, 8)));
+    _crc = static_cast<uint32_t>(_mm_crc32_u64(_crc, lo));
+    return _mm_crc32_u32(_crc, hi);
+}
+
+/// Decodes like decode() while updating the raw (non-inverted) CRC32C state @p _crc.
+template <typename FN_LOOKUP, typename FN_PACK>
+BASE64_CPP_TARGET_SSSE3 uint32_t decode_crc32c(FN_LOOKUP _lookup, FN_PACK _pack, uint8_t const* _input, size_t _size, uint8_t* _output, uint32_t _crc)
+{
+    decode_fold(_lookup, _pack, [&](__m128i const _block) BASE64_CPP_TARGET_SSSE3 {
+        _crc = crc32c_block_table(_crc, _block);
+    }, _input, _size, _output);
+
+    return _crc;
+}
+
+/// SSE4.2 version of decode_crc32c() using the crc32 instruction.
+template <typename FN_LOOKUP, typename FN_PACK>
+BASE64_CPP_TARGET_SSE42 uint32_t decode_crc32c_sse42(FN_LOOKUP _lookup, FN_PACK _pack, uint8_t const* _input, size_t _size, uint8_t* _output, uint32_t _crc)
+{
+    decode_fold(_lookup, _pack, [&](__m128i const _block) BASE64_CPP_TARGET_SSE42 {
+        _crc = crc32c_block_sse42(_crc, _block);
+    }, _input, _size, _output);
+
+    return _crc;
+}
+
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 inline uint32_t decode_crc32c_pshufb_madd(uint8_t const* _input, size_t _size, uint8_t* _output, uint32_t _crc)
+{
+    return decode_crc32c(lookup_pshufb, pack_madd, _input, _size, _output, _crc);
+}
+
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSE42 inline uint32_t decode_crc32c_pshufb_madd_sse42(uint8_t const* _input, size_t _size, uint8_t* _output, uint32_t _crc)
+{
+    return decode_crc32c_sse42(lookup_pshufb, pack_madd, _input, _size, _output, _crc);
+}
+
+// }}}
+// {{{ decode + Adler-32
+
+/// Decodes like decode() while updating the Adler-32 checksum @p _adler.
+///
+/// Per block, the byte sum (psadbw) and the position weighted byte sum
+/// (pmaddubsw with weights 12..1) are accumulated in vector registers,
+/// and only folded into the scalar state before the sums could overflow.
+template <typename FN_LOOKUP, typename FN_PACK>
+BASE64_CPP_TARGET_SSSE3 uint32_t decode_adler32(FN_LOOKUP _lookup, FN_PACK _pack, uint8_t const* _input, size_t _size, uint8_t* _output, uint32_t _adler)
+{
+    using checksum::simple::adler32_base;
+
+    // number of 12-byte blocks that can be summed up before reducing modulo adler32_base
+    constexpr size_t chunkBlocks = checksum::simple::adler32_nmax / 12;
+
+    __m128i const weights = _mm_setr_epi8(12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 0, 0, 0);
+    __m128i const ones = _mm_set1_epi16(1);
+    __m128i const zero = _mm_setzero_si128();
+
+    uint64_t a = _adler & 0xffff;
+    uint64_t b = _adler >> 16;
+
+    __m128i s1 = zero;       // sum of bytes
+    __m128i s1Prefix = zero; // sum of s1 before each block
+    __m128i s2 = zero;       // sum of weighted bytes
+    size_t blocks = 0;
+
+    auto const reduce = [&]() BASE64_CPP_TARGET_SSSE3 {
+        b += blocks * 12 * a + 12 * hsum_epu32(s1Prefix) + hsum_epu32(s2);
+        a += hsum_epu32(s1);
+        a %= adler32_base;
+        b %= adler32_base;
+        s1 = s1Prefix = s2 = zero;
+        blocks = 0;
+    };
+
+    decode_fold(_lookup, _pack, [&](__m128i const _block) BASE64_CPP_TARGET_SSSE3 {
+        s1Prefix = _mm_add_epi32(s1Prefix, s1);
+        s1 = _mm_add_epi32(s1, _mm_sad_epu8(_block, zero));
+        s2 = _mm_add_epi32(s2, _mm_madd_epi16(_mm_maddubs_epi16(_block, weights), ones));
+        if (++blocks == chunkBlocks)
+            reduce();
+    }, _input, _size, _output);
+
+    reduce();
+
+    return static_cast<uint32_t>((b << 16) | a);
+}
+
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 inline uint32_t decode_adler32_pshufb_madd(uint8_t const* _input, size_t _size, uint8_t* _output, uint32_t _adler)
+{
+    return decode_adler32(lookup_pshufb, pack_madd, _input, _size, _output, _adler);
+}
+
+// }}}
+
+}
+
+#endif
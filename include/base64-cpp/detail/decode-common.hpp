@@ -4,6 +4,19 @@
 #include <cstdlib>
 #include <string_view>
 
+namespace base64
+{
+
+/// Input validation performed by decode().
+enum class decode_mode
+{
+    lenient, //!< accepts any number of trailing '=' and ignores non-zero trailing bits
+    strict,  //!< accepts canonical encodings only (RFC 4648, section 3.5)
+    trusted, //!< no validation, for input the caller encoded itself (see decode())
+};
+
+}
+
 namespace base64::detail::decoder
 {
 
@@ -15,4 +28,26 @@ struct invalid_input final
     uint8_t const byte;
 };
 
+/// Inputs of at most this many characters are decoded by decode(std::string_view)
+/// into a stack buffer instead of an over-sized, zero-filled string.
+constexpr inline size_t small_input_size = 64;
+
+/// @returns the number of bytes that @p _size alphabet characters decode into,
+///          ignoring the bits of an incomplete final group.
+constexpr size_t decoded_size_lenient(size_t _size) noexcept
+{
+    return (_size / 4) * 3 + (_size % 4 ? _size % 4 - 1 : 0);
+}
+
+/// Progress of the vectorized part of a JSON string decode, see
+/// sse::decode_json_prefix(), which the scalar loop of decode_json_string()
+/// continues from.
+struct json_prefix
+{
+    size_t position = 0;   //!< input characters processed
+    size_t written = 0;    //!< bytes written
+    uint8_t values[16] {}; //!< 6-bit values of the characters not yet decoded
+    size_t count = 0;      //!< number of those values
+};
+
 }
@@ -78,4 +78,125 @@ size_t decode(Iterator _begin, Iterator _end, Output _output)
     return decodedCount;
 }
 
+/// Tail kernel with the same contract as sse::decode_tail().
+inline size_t decode_tail(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    return decode(_input, _input + _size, _output);
+}
+
+/// Block kernel with the same contract as the SIMD ones: decodes @p _size
+/// characters (a multiple of 4, no padding) into (_size / 4) * 3 bytes and
+/// throws invalid_input on the first non-alphabet character.
+inline void decode_blocks(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    for (size_t i = 0; i < _size; i += 4)
+    {
+        uint8_t const a = alphabetIndexMap[_input[i + 0]];
+        uint8_t const b = alphabetIndexMap[_input[i + 1]];
+        uint8_t const c = alphabetIndexMap[_input[i + 2]];
+        uint8_t const d = alphabetIndexMap[_input[i + 3]];
+
+        if ((a | b | c | d) & 0x40)
+        {
+            auto k = i;
+            while (alphabetIndexMap[_input[k]] <= 63)
+                ++k;
+            throw invalid_input{k, _input[k]};
+        }
+
+        *_output++ = static_cast<uint8_t>(a << 2 | b >> 4);
+        *_output++ = static_cast<uint8_t>(b << 4 | c >> 2);
+        *_output++ = static_cast<uint8_t>(c << 6 | d);
+    }
+}
+
+/// Scalar version of sse::strip_padding_strict(), for the final block @p _block
+/// holding @p _size characters (a multiple of 4, at most 16).
+///
+/// @returns the number of padding characters.
+inline size_t strip_padding_strict(uint8_t* _block, size_t _size)
+{
+    unsigned mask = 0;
+    for (size_t i = 0; i < _size; ++i)
+        if (_block[i] == '=')
+            mask |= 1u << i;
+
+    auto const one = 1u << (_size - 1);
+    auto const two = 3u << (_size - 2);
+    auto const allowed = mask == two ? two : one;
+    if (auto const misplaced = mask & ~allowed; misplaced)
+        throw invalid_input{static_cast<size_t>(__builtin_ctz(misplaced)), '='};
+
+    for (size_t i = 0; i < _size; ++i)
+        if (_block[i] == '=')
+            _block[i] = 'A';
+
+    return static_cast<size_t>(__builtin_popcount(mask));
+}
+
+/// Scalar version of sse::decode_valid_prefix(), working on groups of 4 characters.
+inline size_t decode_valid_prefix(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    for (size_t i = 0; i < _size; i += 4)
+    {
+        uint8_t const a = alphabetIndexMap[_input[i + 0]];
+        uint8_t const b = alphabetIndexMap[_input[i + 1]];
+        uint8_t const c = alphabetIndexMap[_input[i + 2]];
+        uint8_t const d = alphabetIndexMap[_input[i + 3]];
+
+        if ((a | b | c | d) & 0x40)
+        {
+            auto k = i;
+            while (alphabetIndexMap[_input[k]] <= 63)
+                ++k;
+            return k;
+        }
+
+        *_output++ = static_cast<uint8_t>(a << 2 | b >> 4);
+        *_output++ = static_cast<uint8_t>(b << 4 | c >> 2);
+        *_output++ = static_cast<uint8_t>(c << 6 | d);
+    }
+    return _size;
+}
+
+/// Scalar version of sse::decode_json_prefix(): processes nothing, leaving the
+/// whole string to the scalar loop of decode_json_string().
+inline json_prefix decode_json_prefix(uint8_t const*, size_t, uint8_t*)
+{
+    return {};
+}
+
+/// Throws invalid_input for the first character of a fixed size input of
+/// @p _size characters that is not in the alphabet (among the first @p _chars)
+/// or not '=' (padding past them).
+[[noreturn]] inline void throw_invalid_fixed(uint8_t const* _input, size_t _chars, size_t _size)
+{
+    size_t i = 0;
+    while (i < _chars && alphabetIndexMap[_input[i]] <= 63)
+        ++i;
+    while (i < _size && i >= _chars && _input[i] == '=')
+        ++i;
+    throw invalid_input{i, _input[i]};
+}
+
+/// Scalar version of sse::decode_fixed().
+template <size_t N, size_t M>
+void decode_fixed(uint8_t const* _input, uint8_t* _output)
+{
+    constexpr size_t chars = (4 * M + 2) / 3;
+
+    uint8_t values = 0;
+    for (size_t i = 0; i < chars; ++i)
+        values |= alphabetIndexMap[_input[i]];
+
+    bool padding = true;
+    for (size_t i = chars; i < N; ++i)
+        padding &= _input[i] == '=';
+
+    if ((values & 0x40) || !padding)
+        throw_invalid_fixed(_input, chars, N);
+
+    decode(_input, _input + chars, _output);
+}
+
 }
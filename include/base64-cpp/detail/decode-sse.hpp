@@ -1,12 +1,19 @@
 #pragma once
 
 #include "decode-common.hpp"
+#include "decode-simple.hpp"
+#include "decode-vector.hpp"
+#include "target.hpp"
 
+#include <array>
 #include <cstdint>
 #include <cstdlib>
 #include <cassert>
+#include <cstring>
 #include <stdexcept>
 
+#if defined(BASE64_CPP_X86)
+
 #include <immintrin.h>
 
 namespace base64::detail::decoder::sse
@@ -40,15 +47,11 @@ inline __m128i pack_naive(__m128i const _values)
     return masked(t1, 0x00ffffff);
 }
 
-inline __m128i pack_madd(__m128i const _values)
+BASE64_CPP_TARGET_SSSE3 inline __m128i pack_madd(__m128i const _values)
 {
-    // input:  [00dddddd|00cccccc|00bbbbbb|00aaaaaa]
-
-    // merge:  [0000cccc|ccdddddd|0000aaaa|aabbbbbb]
-    __m128i const merge_ab_and_bc = _mm_maddubs_epi16(_values, packed_dword(0x01400140));
-
-    // result: [00000000|aaaaaabb|bbbbcccc|ccdddddd]
-    return _mm_madd_epi16(merge_ab_and_bc, packed_dword(0x00011000));
+    __m128i result;
+    generic::pack_madd<vector::v128>(_values, result);
+    return result;
 }
 
 // }}}
@@ -126,7 +129,7 @@ inline __m128i lookup_base(__m128i const _input)
     return _mm_add_epi8(_input, shift);
 }
 
-inline __m128i lookup_byte_blend(__m128i const _input)
+BASE64_CPP_TARGET_SSE41 inline __m128i lookup_byte_blend(__m128i const _input)
 {
     /*
     improvment of lookup_base
@@ -181,7 +184,7 @@ inline __m128i lookup_byte_blend(__m128i const _input)
     return _mm_add_epi8(_input, shift);
 }
 
-inline __m128i lookup_incremental(__m128i const _input)
+BASE64_CPP_TARGET_SSSE3 inline __m128i lookup_incremental(__m128i const _input)
 {
     /*
     +-------+------------+-----------+--------+
@@ -260,78 +263,36 @@ inline __m128i lookup_incremental(__m128i const _input)
     return _mm_add_epi8(_input, shift);
 }
 
-inline __m128i lookup_pshufb(__m128i const _input)
+/// lookup_pshufb() without the exception: @returns the values of the valid
+/// characters of @p _input and sets @p _invalid to the bit mask of the invalid ones.
+BASE64_CPP_TARGET_SSSE3 inline __m128i lookup_pshufb_masked(__m128i const _input, unsigned& _invalid)
 {
-    /*
-    number of operations:
-    - cmp (le/gt/eq):  3
-    - shift:           1
-    - add/sub:         2
-    - and/or/andnot:   4
-    - movemask:        1
-    - pshufb           3
-    - total:         =14
-    */
-
-    __m128i const higher_nibble = _mm_srli_epi32(_input, 4) & packed_byte(0x0f);
-    const char linv = 1;
-    const char hinv = 0;
-
-    __m128i const lower_bound_LUT = _mm_setr_epi8(
-        /* 0 */ linv, /* 1 */ linv, /* 2 */ 0x2b, /* 3 */ 0x30,
-        /* 4 */ 0x41, /* 5 */ 0x50, /* 6 */ 0x61, /* 7 */ 0x70,
-        /* 8 */ linv, /* 9 */ linv, /* a */ linv, /* b */ linv,
-        /* c */ linv, /* d */ linv, /* e */ linv, /* f */ linv
-    );
-
-    __m128i const upper_bound_LUT = _mm_setr_epi8(
-        /* 0 */ hinv, /* 1 */ hinv, /* 2 */ 0x2b, /* 3 */ 0x39,
-        /* 4 */ 0x4f, /* 5 */ 0x5a, /* 6 */ 0x6f, /* 7 */ 0x7a,
-        /* 8 */ hinv, /* 9 */ hinv, /* a */ hinv, /* b */ hinv,
-        /* c */ hinv, /* d */ hinv, /* e */ hinv, /* f */ hinv
-    );
-
-    __m128i const shift_LUT = _mm_setr_epi8(
-        /* 0 */ 0x00,        /* 1 */ 0x00,        /* 2 */ 0x3e - 0x2b, /* 3 */ 0x34 - 0x30,
-        /* 4 */ 0x00 - 0x41, /* 5 */ 0x0f - 0x50, /* 6 */ 0x1a - 0x61, /* 7 */ 0x29 - 0x70,
-        /* 8 */ 0x00,        /* 9 */ 0x00,        /* a */ 0x00,        /* b */ 0x00,
-        /* c */ 0x00,        /* d */ 0x00,        /* e */ 0x00,        /* f */ 0x00
-    );
-
-    __m128i const upper_bound = _mm_shuffle_epi8(upper_bound_LUT, higher_nibble);
-    __m128i const lower_bound = _mm_shuffle_epi8(lower_bound_LUT, higher_nibble);
-
-    __m128i const below = _mm_cmplt_epi8(_input, lower_bound);
-    __m128i const above = _mm_cmpgt_epi8(_input, upper_bound);
-    __m128i const eq_2f = _mm_cmpeq_epi8(_input, packed_byte(0x2f));
+    __m128i result;
+    generic::lookup_pshufb_masked<vector::v128>(_input, result, _invalid);
+    return result;
+}
 
-    // in_range = not (below or above) or eq_2f
-    // outside  = not in_range = below or above and not eq_2f (from de Morgan law)
-    __m128i const outside = _mm_andnot_si128(eq_2f, above | below);
+BASE64_CPP_TARGET_SSSE3 inline __m128i lookup_pshufb(__m128i const _input)
+{
+    unsigned invalid = 0;
+    __m128i const result = lookup_pshufb_masked(_input, invalid);
 
-    const auto mask = _mm_movemask_epi8(outside);
-    if (mask)
-    {
-        // some characters do not match the valid range
-        for (unsigned i = 0; i < 16; i++)
-        // TODO(christianparpart): Can't this be rewritten into a single bit-test?
-        // - such as instruction for counting the 0's until the first 1 is hit
-        {
-            if (mask & (1 << i))
-            {
-                throw invalid_input{i, 0};
-            }
-        }
-    }
+    // some characters do not match the valid range
+    if (invalid)
+        throw invalid_input{static_cast<size_t>(__builtin_ctz(invalid)), 0};
 
-    __m128i const shift  = _mm_shuffle_epi8(shift_LUT, higher_nibble);
-    __m128i const t0     = _mm_add_epi8(_input, shift);
-    __m128i const result = _mm_add_epi8(t0, _mm_and_si128(eq_2f, packed_byte(-3)));
+    return result;
+}
 
+/// Translation without validation, for decode_mode::trusted.
+BASE64_CPP_TARGET_SSSE3 inline __m128i lookup_shift(__m128i const _input)
+{
+    __m128i result;
+    generic::lookup_shift<vector::v128>(_input, result);
     return result;
 }
 
-inline __m128i lookup_pshufb_bitmask(__m128i const _input)
+BASE64_CPP_TARGET_SSE41 inline __m128i lookup_pshufb_bitmask(__m128i const _input)
 {
     /*
     number of operations:
@@ -416,11 +377,47 @@ inline __m128i lookup_pshufb_bitmask(__m128i const _input)
     return result;
 }
 
+// }}}
+// {{{ padding
+
+/// Strict (RFC 4648, section 3.5) padding check of the final block @p _block
+/// holding @p _size characters (a multiple of 4, at most 16):
+/// '=' may only occupy the last one or two of them.
+///
+/// Replaces the padding by 'A' (value 0), so that the block can be decoded as is.
+///
+/// @returns the number of padding characters.
+inline size_t strip_padding_strict(__m128i& _block, size_t _size)
+{
+    assert(_size % 4 == 0 && _size >= 4 && _size <= 16);
+
+    __m128i const eq = _mm_cmpeq_epi8(_block, packed_byte('='));
+    auto const mask = static_cast<unsigned>(_mm_movemask_epi8(eq));
+
+    auto const one = 1u << (_size - 1);
+    auto const two = 3u << (_size - 2);
+    auto const allowed = mask == two ? two : one;
+    if (auto const misplaced = mask & ~allowed; misplaced)
+        throw invalid_input{static_cast<size_t>(__builtin_ctz(misplaced)), '='};
+
+    _block = _mm_or_si128(_mm_andnot_si128(eq, _block), _mm_and_si128(eq, packed_byte('A')));
+
+    return static_cast<size_t>(__builtin_popcount(mask));
+}
+
 // }}}
 // {{{ decode
 
+/// Stores the lower 12 bytes of @p _value without touching the 4 bytes past them.
+inline void store_12(uint8_t* _out, __m128i const _value)
+{
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(_out), _value);
+    auto const high = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(_value, 8)));
+    std::memcpy(_out + 8, &high, 4);
+}
+
 template <typename FN_LOOKUP, typename FN_PACK>
-void decode(FN_LOOKUP _lookup, FN_PACK _pack, uint8_t const* _input, size_t _size, uint8_t* _output)
+BASE64_CPP_TARGET_SSSE3 void decode(FN_LOOKUP _lookup, FN_PACK _pack, uint8_t const* _input, size_t _size, uint8_t* _output)
 {
     assert(_size % 16 == 0);
 
@@ -469,14 +466,389 @@ void decode(FN_LOOKUP _lookup, FN_PACK _pack, uint8_t const* _input, size_t _siz
         );
         _mm_maskmoveu_si128(shuffled, mask, reinterpret_cast<char*>(out));
 #else
-        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), shuffled);
+        // The last block must not write past the 12 decoded bytes.
+        if (i + 16 < _size)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), shuffled);
+        else
+            store_12(out, shuffled);
 #endif
         out += 12;
     }
 }
 
-#if defined(HAVE_BMI2_INSTRUCTIONS)
-__m128i bswap_si128(__m128i const in) {
+/// The default SSE kernel (lookup_pshufb + pack_madd), as used by the dispatcher.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 inline void decode_pshufb_madd(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    decode(lookup_pshufb, pack_madd, _input, _size, _output);
+}
+
+/// Alternative SSE kernel (lookup_pshufb_bitmask + pack_madd), an autotuning candidate.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSE41 inline void decode_pshufb_bitmask_madd(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    decode(lookup_pshufb_bitmask, pack_madd, _input, _size, _output);
+}
+
+/// Kernel for decode_mode::trusted (lookup_shift + pack_madd): no validation.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 inline void decode_trusted(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    decode(lookup_shift, pack_madd, _input, _size, _output);
+}
+
+/// Decodes 16 character blocks of @p _input (_size is a multiple of 16) as long
+/// as they consist of alphabet characters only.
+///
+/// The invalid character mask of the lookup doubles as a locator of the first
+/// non-alphabet character, such as a terminator or padding, so that embedded
+/// payloads are decoded in a single pass.
+///
+/// @returns the offset of the first non-alphabet character, or @p _size.
+///          All blocks before the one containing it have been decoded.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 inline size_t decode_valid_prefix(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    assert(_size % 16 == 0);
+
+    __m128i const shuf = _mm_setr_epi8(
+            2,  1,  0,
+            6,  5,  4,
+           10,  9,  8,
+           14, 13, 12,
+          char(0xff), char(0xff), char(0xff), char(0xff)
+    );
+
+    uint8_t* out = _output;
+
+    for (size_t i = 0; i < _size; i += 16)
+    {
+        unsigned invalid = 0;
+        __m128i const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + i));
+        __m128i const values = lookup_pshufb_masked(in, invalid);
+        if (invalid)
+            return i + static_cast<size_t>(__builtin_ctz(invalid));
+
+        __m128i const shuffled = _mm_shuffle_epi8(pack_madd(values), shuf);
+
+        if (i + 16 < _size)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), shuffled);
+        else
+            store_12(out, shuffled);
+        out += 12;
+    }
+
+    return _size;
+}
+
+/// For every mask of lanes to remove from 8 lanes: the indices of the lanes
+/// kept, in order, plus @p Offset, followed by @p Fill.
+template <uint8_t Offset, uint8_t Fill>
+constexpr std::array<std::array<uint8_t, 8>, 256> make_keep_lanes_table() noexcept
+{
+    std::array<std::array<uint8_t, 8>, 256> table {};
+    for (unsigned mask = 0; mask < 256; ++mask)
+    {
+        unsigned k = 0;
+        for (unsigned j = 0; j < 8; ++j)
+            if (!(mask & (1u << j)))
+                table[mask][k++] = static_cast<uint8_t>(j + Offset);
+        for (; k < 8; ++k)
+            table[mask][k] = Fill;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> make_kept_count_table() noexcept
+{
+    std::array<uint8_t, 256> table {};
+    for (unsigned mask = 0; mask < 256; ++mask)
+        for (unsigned j = 0; j < 8; ++j)
+            table[mask] += !(mask & (1u << j));
+    return table;
+}
+
+/// Shuffle indices that move lane j to lane j + n (Up) or j - n (!Up),
+/// zeroing the lanes shifted in, for n = 0..16.
+template <bool Up>
+constexpr std::array<std::array<int8_t, 16>, 17> make_shift_table() noexcept
+{
+    std::array<std::array<int8_t, 16>, 17> table {};
+    for (int n = 0; n <= 16; ++n)
+        for (int j = 0; j < 16; ++j)
+        {
+            auto const from = Up ? j - n : j + n;
+            table[n][j] = static_cast<int8_t>(from >= 0 && from < 16 ? from : -128);
+        }
+    return table;
+}
+
+// The lower half is or'ed with the upper one, whose unused lanes (0x80) zero the lanes past the block.
+constexpr inline auto keep_lanes_lo_table = make_keep_lanes_table<0, 0>();
+constexpr inline auto keep_lanes_hi_table = make_keep_lanes_table<8, 0x80>();
+constexpr inline auto kept_count_table = make_kept_count_table();
+constexpr inline auto shift_up_table = make_shift_table<true>();
+constexpr inline auto shift_down_table = make_shift_table<false>();
+
+/// Decodes the body of a JSON string, in which '/' may be escaped as "\/",
+/// 16 characters per iteration, for as long as neither the closing quote nor
+/// a character outside the alphabet (other than an escaped solidus) occurs.
+///
+/// Every block is looked up as it is, so that blocks without a backslash cost
+/// no more than in decode_valid_prefix(). In the others, every backslash must
+/// be followed by '/', and the values of the backslashes are removed from the
+/// block with a single shuffle, whose indices are looked up per half block.
+/// The values are then appended to a vector of pending values with two more
+/// shuffles, which holds the values of the previous blocks that did not fill
+/// a whole block of 16 yet, so that the escapes never shift the input out of
+/// the 16 character grid of the packing.
+///
+/// Stops before the block of the quote or of an invalid character, or before
+/// the final partial block, with the pending values in the returned state.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 inline json_prefix decode_json_prefix(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    __m128i const shuf = _mm_setr_epi8(
+            2,  1,  0,
+            6,  5,  4,
+           10,  9,  8,
+           14, 13, 12,
+          char(0xff), char(0xff), char(0xff), char(0xff)
+    );
+
+    auto const table = [](std::array<int8_t, 16> const& _lut) BASE64_CPP_TARGET_SSSE3 {
+        return _mm_loadu_si128(reinterpret_cast<__m128i const*>(_lut.data()));
+    };
+
+    __m128i pending = _mm_setzero_si128();
+    size_t count = 0;
+    uint8_t* out = _output;
+    size_t i = 0;
+
+    for (; i + 16 <= _size; i += 16)
+    {
+        __m128i const chars = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + i));
+
+        // the quote, '=', the backslash and other characters outside the alphabet are invalid
+        unsigned invalid = 0;
+        __m128i values = lookup_pshufb_masked(chars, invalid);
+        size_t n = 16;
+
+        if (invalid)
+        {
+            // every backslash escapes a solidus, the one in lane 15 escapes the first character of the next block
+            auto const backslash = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, packed_byte('\\'))));
+            auto const slash = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, packed_byte('/'))));
+            if ((invalid & ~backslash) || ((backslash << 1) & ~slash & 0xffff))
+                break;
+            if ((backslash & 0x8000) && (i + 16 == _size || _input[i + 16] != '/'))
+                break;
+
+            // Compacts the lanes kept: the indices of each half are looked up
+            // by its mask, and those of the upper half moved next to the others.
+            auto const lo = backslash & 0xff;
+            auto const hi = backslash >> 8;
+            auto const keptLo = kept_count_table[lo];
+            n = size_t(keptLo) + kept_count_table[hi];
+
+            __m128i const indicesLo = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(keep_lanes_lo_table[lo].data()));
+            __m128i const indicesHi = _mm_unpacklo_epi64(
+                _mm_loadl_epi64(reinterpret_cast<__m128i const*>(keep_lanes_hi_table[hi].data())), packed_byte(0x80));
+            __m128i const indices = _mm_or_si128(indicesLo, _mm_shuffle_epi8(indicesHi, table(shift_up_table[keptLo])));
+
+            // the lanes past n are zeroed, i.e. hold the value of 'A'
+            values = _mm_shuffle_epi8(values, indices);
+        }
+
+        if (n == 16 && count == 0)
+        {
+            // no escapes so far (or the pending values are back in the grid)
+            __m128i const bytes = _mm_shuffle_epi8(pack_madd(values), shuf);
+            if (i + 32 <= _size)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+            else
+                store_12(out, bytes);
+            out += 12;
+            continue;
+        }
+
+        __m128i const combined = _mm_or_si128(pending, _mm_shuffle_epi8(values, table(shift_up_table[count])));
+        if (count + n < 16)
+        {
+            pending = combined;
+            count += n;
+            continue;
+        }
+
+        __m128i const bytes = _mm_shuffle_epi8(pack_madd(combined), shuf);
+        if (i + 32 <= _size)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+        else
+            store_12(out, bytes);
+        out += 12;
+
+        pending = _mm_shuffle_epi8(values, table(shift_down_table[16 - count]));
+        count = count + n - 16;
+    }
+
+    json_prefix state;
+    state.position = i;
+    state.written = static_cast<size_t>(out - _output);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state.values), pending);
+    state.count = count;
+    return state;
+}
+
+/// Loads @p _size (less than 16) characters into the lower lanes of a vector,
+/// without reading past them, and fills the upper lanes with 'A' (value 0).
+inline __m128i load_partial(uint8_t const* _input, size_t _size)
+{
+    __m128i const lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i const upper = _mm_cmpgt_epi8(lanes, _mm_set1_epi8(static_cast<char>(_size - 1)));
+    return _mm_or_si128(vector::v128::load_partial(_input, _size), _mm_and_si128(upper, packed_byte('A')));
+}
+
+/// Decodes the final @p _size (less than 16) characters of a lenient decode(),
+/// after the trailing '=' have been stripped, with the same result as
+/// simple::decode(): decoding stops at the first non-alphabet character.
+///
+/// Unlike simple::decode(), there is neither a prescan nor a byte-at-a-time
+/// loop: the characters are loaded into one vector (padded with 'A'), and a
+/// single lookup yields both their values and the end of the payload. This is
+/// the whole decode() for inputs shorter than 16 characters, such as short
+/// tokens, whose latency is dominated by this setup.
+///
+/// @returns number of bytes written.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 inline size_t decode_tail(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    assert(_size < 16);
+
+    if (!_size)
+        return 0;
+
+    __m128i const shuf = _mm_setr_epi8(
+            2,  1,  0,
+            6,  5,  4,
+           10,  9,  8,
+           14, 13, 12,
+          char(0xff), char(0xff), char(0xff), char(0xff)
+    );
+
+    unsigned invalid = 0;
+    __m128i const values = lookup_pshufb_masked(load_partial(_input, _size), invalid);
+    auto const end = invalid ? static_cast<size_t>(__builtin_ctz(invalid)) : _size;
+
+    // the lookup leaves invalid lanes undefined; they must not carry into the packed bytes
+    __m128i const lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i const tail = _mm_cmpgt_epi8(lanes, _mm_set1_epi8(static_cast<char>(end - 1)));
+
+    auto const outputLength = decoded_size_lenient(end);
+    vector::v128::store_partial(_output, _mm_shuffle_epi8(pack_madd(_mm_andnot_si128(tail, values)), shuf), outputLength);
+    return outputLength;
+}
+
+/// Decodes exactly @p N characters, the encoding of @p M bytes with or without
+/// padding, for fields of a size known at compile time (digests, UUIDs, keys).
+///
+/// The blocks are unrolled into a fixed sequence of loads, lookups and
+/// stores, the final partial block included, so that nothing depends on
+/// the length at run time. The invalid character masks of all blocks and
+/// the padding compares are combined into a single test at the end.
+template <size_t N, size_t M>
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 void decode_fixed(uint8_t const* _input, uint8_t* _output)
+{
+    constexpr size_t chars = (4 * M + 2) / 3;
+    constexpr size_t blocks = chars / 16;
+    constexpr size_t rest = chars % 16;
+
+    __m128i const shuf = _mm_setr_epi8(
+            2,  1,  0,
+            6,  5,  4,
+           10,  9,  8,
+           14, 13, 12,
+          char(0xff), char(0xff), char(0xff), char(0xff)
+    );
+
+    unsigned invalid = 0;
+
+    vector::unroll<blocks>([&](auto _block) BASE64_CPP_TARGET_SSSE3 {
+        constexpr size_t i = decltype(_block)::value;
+        unsigned mask = 0;
+        __m128i const values = lookup_pshufb_masked(_mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + 16 * i)), mask);
+        __m128i const bytes = _mm_shuffle_epi8(pack_madd(values), shuf);
+        invalid |= mask;
+
+        if constexpr (12 * i + 16 <= M)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(_output + 12 * i), bytes);
+        else
+            store_12(_output + 12 * i, bytes);
+    });
+
+    if constexpr (rest != 0)
+    {
+        unsigned mask = 0;
+        __m128i const values = lookup_pshufb_masked(load_partial(_input + 16 * blocks, rest), mask);
+        invalid |= mask;
+        vector::v128::store_partial(_output + 12 * blocks, _mm_shuffle_epi8(pack_madd(values), shuf), M - 12 * blocks);
+    }
+
+    bool padding = true;
+    if constexpr (N > chars)
+        padding &= _input[chars] == '=';
+    if constexpr (N > chars + 1)
+        padding &= _input[chars + 1] == '=';
+
+    if (invalid || !padding)
+        simple::throw_invalid_fixed(_input, chars, N);
+}
+
+/// Decodes RGB24 pixel data straight into RGBA32 pixels.
+///
+/// Every 4 input characters decode into exactly one RGB pixel, so after packing
+/// each dword lane already holds one pixel. It is byte-swapped into place and
+/// completed with @p _alpha within the same register, turning 16 characters
+/// into 4 RGBA pixels (16 bytes) per iteration.
+template <typename FN_LOOKUP, typename FN_PACK>
+BASE64_CPP_TARGET_SSSE3 void decode_rgb_to_rgba(FN_LOOKUP _lookup, FN_PACK _pack, uint8_t const* _input, size_t _size, uint8_t* _output, uint8_t _alpha)
+{
+    assert(_size % 16 == 0);
+
+    uint8_t* out = _output;
+
+    // merged = packed_byte([0RGB|0RGB|0RGB|0RGB]) (per dword MSB to LSB)
+    // rgba   = packed_byte([ABGR|ABGR|ABGR|ABGR]), i.e. R, G, B, A in memory order
+    __m128i const shuf = _mm_setr_epi8(
+            2,  1,  0, char(0xff),
+            6,  5,  4, char(0xff),
+           10,  9,  8, char(0xff),
+           14, 13, 12, char(0xff)
+    );
+    __m128i const alpha = _mm_set1_epi32(static_cast<int>(uint32_t(_alpha) << 24));
+
+    for (size_t i = 0; i < _size; i += 16)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + i));
+        __m128i values;
+
+        try
+        {
+            values = _lookup(in);
+        }
+        catch (invalid_input const& e)
+        {
+            const auto shift = e.offset;
+            throw invalid_input{i + shift, _input[i + shift]};
+        }
+
+        __m128i const merged = _pack(values);
+        __m128i const rgba = _mm_or_si128(_mm_shuffle_epi8(merged, shuf), alpha);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), rgba);
+        out += 16;
+    }
+}
+
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 inline void decode_rgb_to_rgba_pshufb_madd(uint8_t const* _input, size_t _size, uint8_t* _output, uint8_t _alpha)
+{
+    decode_rgb_to_rgba(lookup_pshufb, pack_madd, _input, _size, _output, _alpha);
+}
+
+BASE64_CPP_TARGET_SSSE3 inline __m128i bswap_si128(__m128i const in) {
     return _mm_shuffle_epi8(in, _mm_setr_epi8(
                  3,  2,  1,  0,
                  7,  6,  5,  4,
@@ -485,8 +857,21 @@ __m128i bswap_si128(__m128i const in) {
            ));
 }
 
+/// Packs the 6-bit values of two byte-swapped dwords (8 characters)
+/// into 6 bytes in output order, using pext.
+BASE64_CPP_TARGET_SSE41_BMI2 inline uint64_t pack_bytes(uint64_t v)
+{
+    const uint64_t p  = _pext_u64(v, 0x3f3f3f3f3f3f3f3f);
+
+    const uint64_t b0 = p & 0x0000ff0000ff;
+    const uint64_t b1 = p & 0x00ff0000ff00;
+    const uint64_t b2 = p & 0xff0000ff0000;
+
+    return (b0 << 16) | b1 | (b2 >> 16);
+}
+
 template <typename FN>
-void decode_bmi2(FN lookup, const uint8_t* input, size_t size, uint8_t* output) {
+BASE64_CPP_TARGET_SSE41_BMI2 void decode_bmi2(FN lookup, const uint8_t* input, size_t size, uint8_t* output) {
 
     assert(size % 16 == 0);
 
@@ -501,42 +886,35 @@ void decode_bmi2(FN lookup, const uint8_t* input, size_t size, uint8_t* output)
         {
             values = bswap_si128(lookup(in));
         }
-        catch (invalid_input& e)
+        catch (invalid_input const& e)
         {
             const auto shift = e.offset;
-            throw invalid_input(i + shift, input[i + shift]);
+            throw invalid_input{i + shift, input[i + shift]};
         }
 
         // input:  packed_dword([00dddddd|00cccccc|00bbbbbb|00aaaaaa] x 4)
         // merged: packed_dword([00000000|ddddddcc|ccccbbbb|bbaaaaaa] x 4)
 
-        const uint64_t lo = _mm_extract_epi64(values, 0);
-        const uint64_t hi = _mm_extract_epi64(values, 1);
-
-        uint64_t t0 = _pext_u64(lo, 0x3f3f3f3f3f3f3f3f);
-        uint64_t t1 = _pext_u64(hi, 0x3f3f3f3f3f3f3f3f);
-
-        uint64_t b0, b1, b2;
+        const uint64_t t0 = pack_bytes(static_cast<uint64_t>(_mm_extract_epi64(values, 0)));
+        const uint64_t t1 = pack_bytes(static_cast<uint64_t>(_mm_extract_epi64(values, 1)));
 
-        b0 = t0 & 0x0000ff0000ff;
-        b1 = t0 & 0x00ff0000ff00;
-        b2 = t0 & 0xff0000ff0000;
-        t0 = (b0 << 16) | b1 | (b2 >> 16);
-
-        b0 = t1 & 0x0000ff0000ff;
-        b1 = t1 & 0x00ff0000ff00;
-        b2 = t1 & 0xff0000ff0000;
-        t1 = (b0 << 16) | b1 | (b2 >> 16);
-
-        *reinterpret_cast<uint64_t*>(out + 0)  = t0;
-        *reinterpret_cast<uint64_t*>(out + 6)  = t1;
+        // exactly 12 bytes, also for the last block
+        const uint64_t lo = (t1 << (6*8)) | t0;
+        const uint32_t hi = static_cast<uint32_t>(t1 >> (2*8));
+        std::memcpy(out + 0, &lo, 8);
+        std::memcpy(out + 8, &hi, 4);
         out += 12;
     }
 }
-#endif // defined(HAVE_BMI2_INSTRUCTIONS)
+
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSE41_BMI2 inline void decode_bmi2_pshufb(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    decode_bmi2(lookup_pshufb, _input, _size, _output);
+}
+
 
 // The algorithm by aqrit. It uses a clever hashing of input bytes
-inline void decode_aqrit(const uint8_t* input, size_t size, uint8_t* output)
+BASE64_CPP_TARGET_SSSE3 inline void decode_aqrit(const uint8_t* input, size_t size, uint8_t* output)
 {
     __m128i const delta_asso = _mm_setr_epi8(
             0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
@@ -585,7 +963,10 @@ inline void decode_aqrit(const uint8_t* input, size_t size, uint8_t* output)
         __m128i const t1 = _mm_madd_epi16(t0, _mm_set1_epi32(0x00011000));
         __m128i const t2 = _mm_shuffle_epi8(t1, pack_shuffle);
 
-        _mm_storeu_si128((__m128i*)output, t2);
+        if (i + 16 < size)
+            _mm_storeu_si128((__m128i*)output, t2);
+        else
+            store_12(output, t2);
         output += 12;
     }
 }
@@ -593,3 +974,5 @@ inline void decode_aqrit(const uint8_t* input, size_t size, uint8_t* output)
 // }}}
 
 }
+
+#endif
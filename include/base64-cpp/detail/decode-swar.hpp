@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "decode-common.hpp"
+#include "decode-simple.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace base64::detail::decoder::swar
+{
+
+/// Value of a character at position @p Position (0..3) of a quad, already
+/// shifted into place within the 24 bits of the quad; invalid characters
+/// set bit 24 instead.
+template <unsigned Position>
+constexpr std::array<uint32_t, 256> make_quad_table() noexcept
+{
+    std::array<uint32_t, 256> table {};
+    for (unsigned i = 0; i < 256; ++i)
+    {
+        auto const value = uint32_t(simple::alphabetIndexMap[i]);
+        table[i] = value <= 63 ? value << (6 * (3 - Position)) : uint32_t(1) << 24;
+    }
+    return table;
+}
+
+constexpr inline std::array<std::array<uint32_t, 256>, 4> quad_tables = {
+    make_quad_table<0>(),
+    make_quad_table<1>(),
+    make_quad_table<2>(),
+    make_quad_table<3>(),
+};
+
+/// Stores the lower 48 bits of @p _value in big-endian order (6 bytes).
+inline void store_48(uint8_t* _out, uint64_t _value) noexcept
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    _value <<= 16;
+#else
+    _value = __builtin_bswap64(_value << 16);
+#endif
+    std::memcpy(_out, &_value, 6);
+}
+
+/// Portable block kernel, decoding two quads (8 characters) into one 64-bit
+/// word per iteration: each character is translated by a table of its own,
+/// which already shifts its value into place, so that a quad is the bitwise
+/// or of four lookups, and one test per word detects invalid characters.
+///
+/// Decodes @p _size characters (a multiple of 8) into (_size / 4) * 3 bytes.
+inline void decode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    auto const& [t0, t1, t2, t3] = quad_tables;
+
+    for (size_t i = 0; i < _size; i += 8)
+    {
+        uint8_t const* in = _input + i;
+        uint32_t const q0 = t0[in[0]] | t1[in[1]] | t2[in[2]] | t3[in[3]];
+        uint32_t const q1 = t0[in[4]] | t1[in[5]] | t2[in[6]] | t3[in[7]];
+
+        if ((q0 | q1) >> 24)
+        {
+            auto k = i;
+            while (simple::alphabetIndexMap[_input[k]] <= 63)
+                ++k;
+            throw invalid_input{k, _input[k]};
+        }
+
+        store_48(_output, uint64_t(q0) << 24 | q1);
+        _output += 6;
+    }
+}
+
+/// Portable kernel for decode_mode::trusted: swar::decode() without the test
+/// for invalid characters.
+inline void decode_trusted(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    auto const& [t0, t1, t2, t3] = quad_tables;
+
+    for (size_t i = 0; i < _size; i += 8)
+    {
+        uint8_t const* in = _input + i;
+        uint32_t const q0 = t0[in[0]] | t1[in[1]] | t2[in[2]] | t3[in[3]];
+        uint32_t const q1 = t0[in[4]] | t1[in[5]] | t2[in[6]] | t3[in[7]];
+
+        store_48(_output, uint64_t(q0) << 24 | q1);
+        _output += 6;
+    }
+}
+
+}
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+// Width-generic lookup and pack building blocks of the SIMD decoders,
+// instantiated with the vector types of vector.hpp by decode-sse.hpp (v128)
+// and decode-avx2.hpp (v256).
+
+#include "vector.hpp"
+
+#include <cstdint>
+
+#if defined(BASE64_CPP_X86)
+
+// The generic functions are always inlined into their annotated callers, so
+// their 256-bit vector operands never cross a non-AVX function boundary.
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+namespace base64::detail::decoder::generic
+{
+
+/// Translates the characters of @p _input into their 6-bit values, with a
+/// pshufb lookup of the valid range and shift per higher nibble.
+///
+/// Sets @p _result to the values of the valid characters of @p _input and
+/// @p _invalid to the bit mask of the invalid ones.
+///
+/// Vectors are passed by reference: this function has no target attribute of
+/// its own and is always inlined into its annotated callers.
+template <typename V>
+BASE64_CPP_ALWAYS_INLINE void lookup_pshufb_masked(typename V::type const& _input, typename V::type& _result, unsigned& _invalid)
+{
+    /*
+    number of operations:
+    - cmp (le/gt/eq):  3
+    - shift:           1
+    - add/sub:         2
+    - and/or/andnot:   4
+    - movemask:        1
+    - pshufb           3
+    - total:         =14
+    */
+
+    constexpr int8_t linv = 1;
+    constexpr int8_t hinv = 0;
+
+    static constexpr int8_t lower_bound_LUT[16] = {
+        /* 0 */ linv, /* 1 */ linv, /* 2 */ 0x2b, /* 3 */ 0x30,
+        /* 4 */ 0x41, /* 5 */ 0x50, /* 6 */ 0x61, /* 7 */ 0x70,
+        /* 8 */ linv, /* 9 */ linv, /* a */ linv, /* b */ linv,
+        /* c */ linv, /* d */ linv, /* e */ linv, /* f */ linv
+    };
+
+    static constexpr int8_t upper_bound_LUT[16] = {
+        /* 0 */ hinv, /* 1 */ hinv, /* 2 */ 0x2b, /* 3 */ 0x39,
+        /* 4 */ 0x4f, /* 5 */ 0x5a, /* 6 */ 0x6f, /* 7 */ 0x7a,
+        /* 8 */ hinv, /* 9 */ hinv, /* a */ hinv, /* b */ hinv,
+        /* c */ hinv, /* d */ hinv, /* e */ hinv, /* f */ hinv
+    };
+
+    static constexpr int8_t shift_LUT[16] = {
+        /* 0 */ 0x00,        /* 1 */ 0x00,        /* 2 */ 0x3e - 0x2b, /* 3 */ 0x34 - 0x30,
+        /* 4 */ 0x00 - 0x41, /* 5 */ 0x0f - 0x50, /* 6 */ 0x1a - 0x61, /* 7 */ 0x29 - 0x70,
+        /* 8 */ 0x00,        /* 9 */ 0x00,        /* a */ 0x00,        /* b */ 0x00,
+        /* c */ 0x00,        /* d */ 0x00,        /* e */ 0x00,        /* f */ 0x00
+    };
+
+    auto const higher_nibble = V::and_(V::template srli32<4>(_input), V::splat(0x0f));
+
+    auto const upper_bound = V::shuffle(V::table(upper_bound_LUT), higher_nibble);
+    auto const lower_bound = V::shuffle(V::table(lower_bound_LUT), higher_nibble);
+
+    auto const below = V::cmpgt(lower_bound, _input);
+    auto const above = V::cmpgt(_input, upper_bound);
+    auto const eq_2f = V::cmpeq(_input, V::splat(0x2f));
+
+    // in_range = not (below or above) or eq_2f
+    // outside  = not in_range = below or above and not eq_2f (from de Morgan law)
+    auto const outside = V::andnot(eq_2f, V::or_(above, below));
+
+    _invalid = V::movemask(outside);
+
+    auto const shift  = V::shuffle(V::table(shift_LUT), higher_nibble);
+    auto const t0     = V::add(_input, shift);
+    _result = V::add(t0, V::and_(eq_2f, V::splat(static_cast<uint8_t>(-3))));
+}
+
+/// Translates the characters of @p _input into their 6-bit values with the
+/// shift LUT alone, for input known to be valid: '/' shares its higher nibble
+/// with '+', and is told apart by moving its LUT index down by one.
+///
+/// Non-alphabet characters translate into unspecified values.
+template <typename V>
+BASE64_CPP_ALWAYS_INLINE void lookup_shift(typename V::type const& _input, typename V::type& _result)
+{
+    /*
+    number of operations:
+    - cmp (eq):        1
+    - shift:           1
+    - add/sub:         2
+    - and:             1
+    - pshufb           1
+    - total:         = 6
+    */
+
+    static constexpr int8_t shift_LUT[16] = {
+        /* 0 */ 0x00,        /* 1 */ 0x3f - 0x2f, /* 2 */ 0x3e - 0x2b, /* 3 */ 0x34 - 0x30,
+        /* 4 */ 0x00 - 0x41, /* 5 */ 0x0f - 0x50, /* 6 */ 0x1a - 0x61, /* 7 */ 0x29 - 0x70,
+        /* 8 */ 0x00,        /* 9 */ 0x00,        /* a */ 0x00,        /* b */ 0x00,
+        /* c */ 0x00,        /* d */ 0x00,        /* e */ 0x00,        /* f */ 0x00
+    };
+
+    auto const higher_nibble = V::and_(V::template srli32<4>(_input), V::splat(0x0f));
+    auto const eq_2f = V::cmpeq(_input, V::splat(0x2f));
+
+    // eq_2f is -1 for '/', selecting entry 1 instead of 2
+    auto const shift = V::shuffle(V::table(shift_LUT), V::add(higher_nibble, eq_2f));
+    _result = V::add(_input, shift);
+}
+
+/// Packs the 6-bit values of every dword of @p _values into its lower 24 bits,
+/// with two multiply-adds.
+template <typename V>
+BASE64_CPP_ALWAYS_INLINE void pack_madd(typename V::type const& _values, typename V::type& _result)
+{
+    // input:  [00dddddd|00cccccc|00bbbbbb|00aaaaaa]
+
+    // merge:  [0000cccc|ccdddddd|0000aaaa|aabbbbbb]
+    auto const merge_ab_and_bc = V::maddubs(_values, V::splat32(0x01400140));
+
+    // result: [00000000|aaaaaabb|bbbbcccc|ccdddddd]
+    _result = V::madd(merge_ab_and_bc, V::splat32(0x00011000));
+}
+
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+#endif
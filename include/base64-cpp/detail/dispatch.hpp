@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "cpu.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <string_view>
+
+namespace base64::detail::dispatch
+{
+
+/// A kernel implementation together with the CPU features it requires.
+template <typename Fn>
+struct kernel
+{
+    std::string_view name;
+    cpu::feature_set requirements;
+    Fn function;
+};
+
+/// @returns whether all features required by @p _kernel are in @p _available.
+template <typename Fn>
+constexpr bool is_supported(kernel<Fn> const& _kernel, cpu::feature_set _available) noexcept
+{
+    return (_kernel.requirements & _available) == _kernel.requirements;
+}
+
+/// @returns the first supported kernel of @p _kernels, which is ordered from
+///          best to worst and must end with a kernel without requirements.
+template <typename Fn, size_t N>
+constexpr Fn select(std::array<kernel<Fn>, N> const& _kernels, cpu::feature_set _available) noexcept
+{
+    for (auto const& k: _kernels)
+        if (is_supported(k, _available))
+            return k.function;
+    return _kernels.back().function;
+}
+
+template <typename Fn, size_t N>
+Fn select(std::array<kernel<Fn>, N> const& _kernels) noexcept
+{
+    return select(_kernels, cpu::available_features());
+}
+
+}
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "encode-sse.hpp"
+#include "target.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+#if defined(BASE64_CPP_X86)
+
+#include <immintrin.h>
+
+namespace base64::detail::encoder::avx2
+{
+
+// {{{ load
+
+/// Loads 24 bytes as two 128-bit halves of 12 bytes each, so that every
+/// 128-bit lane holds the input of one SSE block in its lower 12 bytes:
+/// pshufb cannot move bytes across lanes.
+///
+/// Reads 28 bytes, of which the last 4 are ignored.
+BASE64_CPP_TARGET_AVX2 inline __m256i load_lanes(uint8_t const* _input)
+{
+    __m128i const lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_input));
+    __m128i const hi = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + 12));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// }}}
+// {{{ unpack
+
+/// 256-bit version of sse::unpack_mul, per 128-bit lane.
+BASE64_CPP_TARGET_AVX2 inline __m256i unpack_mul(__m256i const _input)
+{
+    __m256i const in = _mm256_shuffle_epi8(_input, _mm256_setr_epi8(
+        1,  0,  2,  1,
+        4,  3,  5,  4,
+        7,  6,  8,  7,
+       10,  9, 11, 10,
+        1,  0,  2,  1,
+        4,  3,  5,  4,
+        7,  6,  8,  7,
+       10,  9, 11, 10
+    ));
+
+    __m256i const t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    __m256i const t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+
+    __m256i const t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    __m256i const t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+
+    return _mm256_or_si256(t1, t3);
+}
+
+// }}}
+// {{{ lookup
+
+/// 256-bit version of sse::lookup_pshufb.
+BASE64_CPP_TARGET_AVX2 inline __m256i lookup_pshufb(__m256i const _input)
+{
+    __m256i result = _mm256_subs_epu8(_input, _mm256_set1_epi8(51));
+
+    __m256i const less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), _input);
+    result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+    __m256i const shift_LUT = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A',      0,        0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A',      0,        0
+    );
+
+    result = _mm256_shuffle_epi8(shift_LUT, result);
+    return _mm256_add_epi8(result, _input);
+}
+
+// }}}
+// {{{ encode
+
+/// Encodes @p _size bytes (a multiple of 12) from @p _input into
+/// (_size / 12) * 16 characters at @p _output, 24 bytes per iteration.
+///
+/// The last block or two, for which load_lanes() would read past the end of
+/// the input, are left to the SSE encoder.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_AVX2 inline void encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    assert(_size % 12 == 0);
+
+    uint8_t* out = _output;
+    size_t i = 0;
+
+    for (; i + 28 <= _size; i += 24)
+    {
+        __m256i const indices = unpack_mul(load_lanes(_input + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), lookup_pshufb(indices));
+        out += 32;
+    }
+
+    if (i < _size)
+        sse::encode(_input + i, _size - i, out);
+}
+
+// }}}
+
+}
+
+#endif
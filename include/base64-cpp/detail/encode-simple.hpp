@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "decode-common.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace base64::detail::encoder::simple
+{
+
+/// Encodes the bytes in range [_begin, _end) into @p _output,
+/// including the trailing '=' padding.
+///
+/// @returns number of characters written.
+template <typename Iterator, typename Output>
+size_t encode(Iterator _begin, Iterator _end, Output _output)
+{
+    using decoder::alphabet;
+
+    auto const byte = [](auto c) -> uint8_t { return static_cast<uint8_t>(c); };
+
+    auto out = _output;
+    size_t encodedCount = 0;
+    Iterator input = _begin;
+
+    while (input != _end)
+    {
+        uint8_t const a = byte(*input++);
+        bool const hasB = input != _end;
+        uint8_t const b = hasB ? byte(*input++) : 0;
+        bool const hasC = hasB && input != _end;
+        uint8_t const c = hasC ? byte(*input++) : 0;
+
+        *out++ = alphabet[a >> 2];
+        *out++ = alphabet[((a & 0x03) << 4) | (b >> 4)];
+        *out++ = hasB ? alphabet[((b & 0x0f) << 2) | (c >> 6)] : '=';
+        *out++ = hasC ? alphabet[c & 0x3f] : '=';
+
+        encodedCount += 4;
+    }
+
+    return encodedCount;
+}
+
+/// Block kernel with the same contract as the SIMD ones: encodes @p _size
+/// bytes (a multiple of 3) into (_size / 3) * 4 characters.
+inline void encode_blocks(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    encode(_input, _input + _size, _output);
+}
+
+/// Scalar version of sse::encode_fixed().
+template <size_t M>
+void encode_fixed(uint8_t const* _input, uint8_t* _output)
+{
+    encode(_input, _input + M, _output);
+}
+
+}
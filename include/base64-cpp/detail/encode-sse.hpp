@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "decode-common.hpp"
+#include "target.hpp"
+#include "vector.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(BASE64_CPP_X86)
+
+#include <immintrin.h>
+
+namespace base64::detail::encoder::sse
+{
+
+#define packed_byte(b) _mm_set1_epi8(uint8_t(b))
+#define packed_dword(x) _mm_set1_epi32(x)
+
+// {{{ unpack
+
+BASE64_CPP_TARGET_SSSE3 inline __m128i unpack_mul(__m128i const _input)
+{
+    // input, bytes MSB to LSB: [? ? ? ?|l k j i|h g f e|d c b a]
+
+    // in:     [k l j k|h i g h|e f d e|b c a b]
+    __m128i const in = _mm_shuffle_epi8(_input, _mm_setr_epi8(
+        1,  0,  2,  1,
+        4,  3,  5,  4,
+        7,  6,  8,  7,
+       10,  9, 11, 10
+    ));
+
+    // t0 = [0000kkkk|LL000000|JJJJJJ00|00000000] x 4
+    // t1 = [00000000|00kkkkLL|00000000|00JJJJJJ] x 4
+    __m128i const t0 = _mm_and_si128(in, packed_dword(0x0fc0fc00));
+    __m128i const t1 = _mm_mulhi_epu16(t0, packed_dword(0x04000040));
+
+    // t2 = [00000000|00llllll|000000jj|KKKK0000] x 4
+    // t3 = [00llllll|00000000|00jjKKKK|00000000] x 4
+    __m128i const t2 = _mm_and_si128(in, packed_dword(0x003f03f0));
+    __m128i const t3 = _mm_mullo_epi16(t2, packed_dword(0x01000010));
+
+    // result: [00llllll|00kkkkLL|00jjKKKK|00JJJJJJ] x 4
+    return _mm_or_si128(t1, t3);
+}
+
+// }}}
+// {{{ lookup
+
+BASE64_CPP_TARGET_SSSE3 inline __m128i lookup_pshufb(__m128i const _input)
+{
+    /*
+    number of operations:
+    - subs/add:        2
+    - cmp:             1
+    - and/or:          2
+    - pshufb:          1
+    - total:          =6
+    */
+
+    // reduce  0..51 -> 0
+    //        52..61 -> 1 .. 10
+    //            62 -> 11
+    //            63 -> 12
+    __m128i result = _mm_subs_epu8(_input, packed_byte(51));
+
+    // distinguish between ranges 0..25 and 26..51:
+    //         0 .. 25 -> becomes 13
+    //        26 .. 51 -> remains 0
+    __m128i const less = _mm_cmpgt_epi8(packed_byte(26), _input);
+    result = _mm_or_si128(result, _mm_and_si128(less, packed_byte(13)));
+
+    __m128i const shift_LUT = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A',      0,        0
+    );
+
+    result = _mm_shuffle_epi8(shift_LUT, result);
+    return _mm_add_epi8(result, _input);
+}
+
+// }}}
+// {{{ encode
+
+/// Encodes @p _size bytes (a multiple of 12) from @p _input into
+/// (_size / 12) * 16 characters at @p _output.
+///
+/// Each iteration loads 16 bytes of which only the lower 12 are used,
+/// so the final block is staged through a local buffer in order to
+/// never read past the end of the input.
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 inline void encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+    assert(_size % 12 == 0);
+
+    uint8_t* out = _output;
+    size_t i = 0;
+
+    auto const encodeBlock = [&](__m128i _in) BASE64_CPP_TARGET_SSSE3 {
+        __m128i const indices = unpack_mul(_in);
+        __m128i const result = lookup_pshufb(indices);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), result);
+        out += 16;
+    };
+
+    for (; i + 16 <= _size; i += 12)
+        encodeBlock(_mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + i)));
+
+    if (i < _size)
+    {
+        alignas(16) uint8_t tail[16] = {};
+        std::memcpy(tail, _input + i, 12);
+        encodeBlock(_mm_load_si128(reinterpret_cast<__m128i const*>(tail)));
+    }
+}
+
+/// Encodes exactly @p M bytes into encoded_size(M) characters, including
+/// padding, for fields of a size known at compile time.
+///
+/// Like decoder::sse::decode_fixed(), the blocks are unrolled into a fixed
+/// sequence of loads and stores; the final partial block is loaded without
+/// reading past the input and gets its '=' padding within the register.
+template <size_t M>
+BASE64_CPP_FLATTEN BASE64_CPP_TARGET_SSSE3 void encode_fixed(uint8_t const* _input, uint8_t* _output)
+{
+    constexpr size_t blocks = M / 12;
+    constexpr size_t rest = M % 12;
+
+    vector::unroll<blocks>([&](auto _block) BASE64_CPP_TARGET_SSSE3 {
+        constexpr size_t i = decltype(_block)::value;
+        __m128i in;
+        if constexpr (12 * i + 16 <= M)
+            in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + 12 * i));
+        else
+            in = vector::v128::load_partial(_input + 12 * i, 12);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(_output + 16 * i), lookup_pshufb(unpack_mul(in)));
+    });
+
+    if constexpr (rest != 0)
+    {
+        constexpr size_t chars = (4 * rest + 2) / 3;
+        constexpr size_t padded = ((rest + 2) / 3) * 4;
+
+        __m128i const result = lookup_pshufb(unpack_mul(vector::v128::load_partial(_input + 12 * blocks, rest)));
+        __m128i const lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        __m128i const padding = _mm_cmpgt_epi8(lanes, _mm_set1_epi8(char(chars - 1)));
+        __m128i const encoded = _mm_or_si128(_mm_andnot_si128(padding, result), _mm_and_si128(padding, packed_byte('=')));
+
+        if constexpr (padded == 16)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(_output + 16 * blocks), encoded);
+        else
+            vector::v128::store_partial(_output + 16 * blocks, encoded, padded);
+    }
+}
+
+// }}}
+
+}
+
+#endif
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+// Per-function instruction set annotations.
+//
+// Every SIMD kernel carries the target attribute of the instruction sets it
+// uses, so that it compiles regardless of the -m / -march flags of the
+// including translation unit. Everything else, in particular the dispatch
+// code, stays at the baseline of the build and only calls a kernel after
+// the running CPU has been checked for its features.
+//
+// Lambdas inside an annotated function do not inherit its target and must
+// be annotated as well (after their parameter list).
+//
+// SSE2 is part of the x86-64 baseline and needs no annotation.
+//
+// The x86 kernels, and the x86 specific headers they need, are only compiled
+// when BASE64_CPP_X86 is defined, i.e. on x86 unless BASE64_CPP_PORTABLE is
+// defined. Otherwise only the portable kernels are available.
+//
+// The kernel entry points, i.e. the functions registered with the dispatcher,
+// are also flattened: their lookup and pack building blocks reach the templated
+// loops as function pointers, which GCC does not reliably propagate and inline
+// across target annotated functions on its own.
+
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && !defined(BASE64_CPP_PORTABLE)
+    #define BASE64_CPP_X86 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define BASE64_CPP_TARGET(isa) __attribute__((target(isa)))
+    #define BASE64_CPP_FLATTEN __attribute__((flatten))
+    #define BASE64_CPP_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+    #define BASE64_CPP_TARGET(isa)
+    #define BASE64_CPP_FLATTEN
+    #define BASE64_CPP_ALWAYS_INLINE inline
+#endif
+
+#define BASE64_CPP_TARGET_SSSE3      BASE64_CPP_TARGET("ssse3")
+#define BASE64_CPP_TARGET_SSE41      BASE64_CPP_TARGET("sse4.1")
+#define BASE64_CPP_TARGET_SSE42      BASE64_CPP_TARGET("sse4.2")
+#define BASE64_CPP_TARGET_SSE41_BMI2 BASE64_CPP_TARGET("sse4.1,bmi2")
+#define BASE64_CPP_TARGET_AVX2       BASE64_CPP_TARGET("avx2")
+#define BASE64_CPP_TARGET_AVX2_BMI2  BASE64_CPP_TARGET("avx2,bmi2")
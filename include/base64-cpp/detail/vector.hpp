@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+// Thin vector abstraction, so that the lookup and pack building blocks of the
+// kernels are written once (see decode-vector.hpp) and instantiated per width.
+//
+// Every width provides the same set of static operations on packed bytes
+// (and packed dwords where noted), with the semantics of the SSE instruction
+// of the same name. The operations carry the target attribute of the
+// instructions they use; the generic code calling them does not, and is
+// inlined into the annotated (and flattened) kernel entry points.
+
+#include "target.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(BASE64_CPP_X86)
+
+#include <immintrin.h>
+
+namespace base64::detail::vector
+{
+
+/// Calls @p _f with std::integral_constant<size_t, I> for I in [0, Count),
+/// as a fixed sequence of calls, for kernels of compile-time size.
+template <typename F, size_t... I>
+BASE64_CPP_ALWAYS_INLINE void unroll(F&& _f, std::index_sequence<I...>)
+{
+    (_f(std::integral_constant<size_t, I> {}), ...);
+}
+
+template <size_t Count, typename F>
+BASE64_CPP_ALWAYS_INLINE void unroll(F&& _f)
+{
+    unroll(_f, std::make_index_sequence<Count> {});
+}
+
+/// 128-bit vectors (SSE2, SSSE3 for shuffle and the multiply-adds).
+struct v128
+{
+    using type = __m128i;
+    static constexpr unsigned width = 16;
+
+    static type splat(uint8_t _byte) noexcept { return _mm_set1_epi8(static_cast<char>(_byte)); }
+    static type splat32(uint32_t _dword) noexcept { return _mm_set1_epi32(static_cast<int>(_dword)); }
+
+    /// @returns the 16 byte table @p _lut, as used by shuffle().
+    static type table(int8_t const (&_lut)[16]) noexcept
+    {
+        return _mm_loadu_si128(reinterpret_cast<__m128i const*>(_lut));
+    }
+
+    /// Loads @p _size (less than 16) bytes into the lower lanes, without
+    /// reading past them, and zeroes the upper lanes.
+    static type load_partial(uint8_t const* _input, size_t _size) noexcept
+    {
+        auto const loadBelow8 = [](uint8_t const* _data, size_t _count) -> uint64_t {
+            uint64_t value = 0;
+            unsigned shift = 0;
+            if (_count & 4)
+            {
+                uint32_t t;
+                std::memcpy(&t, _data, 4);
+                value = t;
+                _data += 4;
+                shift = 32;
+            }
+            if (_count & 2)
+            {
+                uint16_t t;
+                std::memcpy(&t, _data, 2);
+                value |= uint64_t(t) << shift;
+                _data += 2;
+                shift += 16;
+            }
+            if (_count & 1)
+                value |= uint64_t(*_data) << shift;
+            return value;
+        };
+
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+        if (_size >= 8)
+        {
+            std::memcpy(&lo, _input, 8);
+            hi = loadBelow8(_input + 8, _size - 8);
+        }
+        else
+            lo = loadBelow8(_input, _size);
+
+        return _mm_set_epi64x(static_cast<long long>(hi), static_cast<long long>(lo));
+    }
+
+    /// Stores the lower @p _size (less than 16) bytes of @p _value without
+    /// touching the bytes past them.
+    static void store_partial(uint8_t* _out, type _value, size_t _size) noexcept
+    {
+        if (_size & 8)
+        {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(_out), _value);
+            _value = _mm_srli_si128(_value, 8);
+            _out += 8;
+        }
+        if (_size & 4)
+        {
+            auto const t = static_cast<uint32_t>(_mm_cvtsi128_si32(_value));
+            std::memcpy(_out, &t, 4);
+            _value = _mm_srli_si128(_value, 4);
+            _out += 4;
+        }
+        if (_size & 2)
+        {
+            auto const t = static_cast<uint16_t>(_mm_cvtsi128_si32(_value));
+            std::memcpy(_out, &t, 2);
+            _value = _mm_srli_si128(_value, 2);
+            _out += 2;
+        }
+        if (_size & 1)
+            *_out = static_cast<uint8_t>(_mm_cvtsi128_si32(_value));
+    }
+
+    static type add(type _a, type _b) noexcept { return _mm_add_epi8(_a, _b); }
+    static type and_(type _a, type _b) noexcept { return _mm_and_si128(_a, _b); }
+    static type or_(type _a, type _b) noexcept { return _mm_or_si128(_a, _b); }
+    static type andnot(type _a, type _b) noexcept { return _mm_andnot_si128(_a, _b); }
+    static type cmpeq(type _a, type _b) noexcept { return _mm_cmpeq_epi8(_a, _b); }
+    static type cmpgt(type _a, type _b) noexcept { return _mm_cmpgt_epi8(_a, _b); }
+    static unsigned movemask(type _a) noexcept { return static_cast<unsigned>(_mm_movemask_epi8(_a)); }
+
+    template <int N>
+    static type srli32(type _a) noexcept { return _mm_srli_epi32(_a, N); }
+
+    BASE64_CPP_TARGET_SSSE3 static type shuffle(type _table, type _indices) noexcept
+    {
+        return _mm_shuffle_epi8(_table, _indices);
+    }
+
+    BASE64_CPP_TARGET_SSSE3 static type maddubs(type _a, type _b) noexcept { return _mm_maddubs_epi16(_a, _b); }
+    BASE64_CPP_TARGET_SSSE3 static type madd(type _a, type _b) noexcept { return _mm_madd_epi16(_a, _b); }
+};
+
+/// 256-bit vectors (AVX2); tables and shuffles work per 128-bit lane.
+struct v256
+{
+    using type = __m256i;
+    static constexpr unsigned width = 32;
+
+    BASE64_CPP_TARGET_AVX2 static type splat(uint8_t _byte) noexcept { return _mm256_set1_epi8(static_cast<char>(_byte)); }
+    BASE64_CPP_TARGET_AVX2 static type splat32(uint32_t _dword) noexcept { return _mm256_set1_epi32(static_cast<int>(_dword)); }
+
+    BASE64_CPP_TARGET_AVX2 static type table(int8_t const (&_lut)[16]) noexcept
+    {
+        return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(_lut)));
+    }
+
+    BASE64_CPP_TARGET_AVX2 static type add(type _a, type _b) noexcept { return _mm256_add_epi8(_a, _b); }
+    BASE64_CPP_TARGET_AVX2 static type and_(type _a, type _b) noexcept { return _mm256_and_si256(_a, _b); }
+    BASE64_CPP_TARGET_AVX2 static type or_(type _a, type _b) noexcept { return _mm256_or_si256(_a, _b); }
+    BASE64_CPP_TARGET_AVX2 static type andnot(type _a, type _b) noexcept { return _mm256_andnot_si256(_a, _b); }
+    BASE64_CPP_TARGET_AVX2 static type cmpeq(type _a, type _b) noexcept { return _mm256_cmpeq_epi8(_a, _b); }
+    BASE64_CPP_TARGET_AVX2 static type cmpgt(type _a, type _b) noexcept { return _mm256_cmpgt_epi8(_a, _b); }
+    BASE64_CPP_TARGET_AVX2 static unsigned movemask(type _a) noexcept { return static_cast<unsigned>(_mm256_movemask_epi8(_a)); }
+
+    template <int N>
+    BASE64_CPP_TARGET_AVX2 static type srli32(type _a) noexcept { return _mm256_srli_epi32(_a, N); }
+
+    BASE64_CPP_TARGET_AVX2 static type shuffle(type _table, type _indices) noexcept
+    {
+        return _mm256_shuffle_epi8(_table, _indices);
+    }
+
+    BASE64_CPP_TARGET_AVX2 static type maddubs(type _a, type _b) noexcept { return _mm256_maddubs_epi16(_a, _b); }
+    BASE64_CPP_TARGET_AVX2 static type madd(type _a, type _b) noexcept { return _mm256_madd_epi16(_a, _b); }
+};
+
+}
+
+#endif
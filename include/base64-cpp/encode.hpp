@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/detail/compiled.hpp>
+#include <base64-cpp/detail/encode-avx2.hpp>
+#include <base64-cpp/detail/encode-simple.hpp>
+#include <base64-cpp/detail/encode-sse.hpp>
+#include <base64-cpp/detail/dispatch.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace base64::detail::encoder
+{
+
+/// Block encoding kernel: encodes @p _size bytes (a multiple of 12)
+/// into (_size / 12) * 16 characters.
+using kernel_fn = void (*)(uint8_t const* _input, size_t _size, uint8_t* _output);
+
+/// All encoding kernels, ordered from best to worst.
+inline constexpr std::array kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<kernel_fn>{"avx2", cpu::to_set(cpu::feature::AVX2), &avx2::encode},
+    dispatch::kernel<kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &sse::encode},
+#endif
+    dispatch::kernel<kernel_fn>{"simple", 0, &simple::encode_blocks},
+};
+
+/// @returns the kernel used by base64::encode(), selected on first use.
+inline kernel_fn& selected_kernel() noexcept
+{
+    static kernel_fn kernel = dispatch::select(kernels);
+    return kernel;
+}
+
+}
+
+namespace base64
+{
+
+/// @returns the number of characters required to encode @p _size bytes, including padding.
+constexpr size_t encoded_size(size_t _size) noexcept
+{
+    return ((_size + 2) / 3) * 4;
+}
+
+/// Encodes @p _size bytes (a multiple of 12) into (_size / 12) * 16 characters
+/// using the best kernel available on the running CPU.
+inline void encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+{
+#if defined(BASE64_CPP_COMPILED)
+    base64_cpp_encode(_input, _size, _output);
+#else
+    detail::encoder::selected_kernel()(_input, _size, _output);
+#endif
+}
+
+namespace detail::encoder
+{
+    /// Encodes @p _size bytes into @p _output, including the trailing '=' padding:
+    /// all whole blocks of 12 bytes with the block kernel, the rest byte by byte.
+    ///
+    /// @returns number of characters written, i.e. encoded_size(_size).
+    inline size_t encode_padded(uint8_t const* _input, size_t _size, uint8_t* _output)
+    {
+        auto const mainInputLength = _size - _size % 12;
+        auto const mainOutputLength = (mainInputLength / 12) * 16;
+
+        if (mainInputLength)
+            base64::encode(_input, mainInputLength, _output);
+
+        return mainOutputLength
+               + simple::encode(_input + mainInputLength, _input + _size, _output + mainOutputLength);
+    }
+}
+
+inline std::string encode(std::string_view _input)
+{
+    std::string output;
+    output.resize(encoded_size(_input.size()));
+
+    detail::encoder::encode_padded(reinterpret_cast<uint8_t const*>(_input.data()),
+                                   _input.size(),
+                                   reinterpret_cast<uint8_t*>(output.data()));
+
+    return output;
+}
+
+} // namespace base64
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/encode.hpp>
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#if __has_include(<span>) && __cplusplus > 201703L
+    #include <span>
+#endif
+
+namespace base64::detail::fixed
+{
+
+template <typename T>
+struct identity
+{
+    using type = T;
+};
+
+/// @returns the number of characters of the unpadded encoding of @p _size bytes.
+constexpr size_t unpadded_size(size_t _size) noexcept
+{
+    return (4 * _size + 2) / 3;
+}
+
+/// @returns the number of bytes of the unpadded encoding of @p _size characters,
+///          the default M of decode<N, M>(), or 0 if @p _size is a multiple of 4:
+///          44 characters are either 32 bytes with padding, or 33 without.
+constexpr size_t default_decoded_size(size_t _size) noexcept
+{
+    return _size % 4 ? (_size * 3) / 4 : 0;
+}
+
+/// Whether M has been given for N characters, or defaults to an unambiguous size.
+template <size_t N, size_t M>
+inline constexpr bool has_decoded_size = M != 0 || N == 0;
+
+/// Fixed size kernel: decodes or encodes a compile-time number of characters or bytes.
+using kernel_fn = void (*)(uint8_t const* _input, uint8_t* _output);
+
+/// Decoding kernels for N characters into M bytes, ordered from best to worst.
+template <size_t N, size_t M>
+inline constexpr std::array decode_kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &decoder::sse::decode_fixed<N, M>},
+#endif
+    dispatch::kernel<kernel_fn>{"simple", 0, &decoder::simple::decode_fixed<N, M>},
+};
+
+/// Encoding kernels for M bytes, ordered from best to worst.
+template <size_t M>
+inline constexpr std::array encode_kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &encoder::sse::encode_fixed<M>},
+#endif
+    dispatch::kernel<kernel_fn>{"simple", 0, &encoder::simple::encode_fixed<M>},
+};
+
+template <size_t N, size_t M>
+kernel_fn& selected_decode_kernel() noexcept
+{
+    static kernel_fn kernel = dispatch::select(decode_kernels<N, M>);
+    return kernel;
+}
+
+template <size_t M>
+kernel_fn& selected_encode_kernel() noexcept
+{
+    static kernel_fn kernel = dispatch::select(encode_kernels<M>);
+    return kernel;
+}
+
+template <size_t N, size_t M>
+std::array<uint8_t, M> decode(char const* _input)
+{
+    static_assert(N == unpadded_size(M) || N == encoded_size(M),
+                  "N must be the length of the encoding of M bytes, with or without padding");
+
+    std::array<uint8_t, M> output;
+    selected_decode_kernel<N, M>()(reinterpret_cast<uint8_t const*>(_input), output.data());
+    return output;
+}
+
+template <size_t M>
+std::array<char, encoded_size(M)> encode(uint8_t const* _input)
+{
+    std::array<char, encoded_size(M)> output;
+    selected_encode_kernel<M>()(_input, reinterpret_cast<uint8_t*>(output.data()));
+    return output;
+}
+
+} // namespace base64::detail::fixed
+
+namespace base64
+{
+
+/// Decodes a field of exactly @p N characters, known at compile time, into
+/// @p M bytes, e.g. decode<22>(uuid) or decode<44, 32>(sha256) for a padded
+/// digest. M defaults to the size of an unpadded encoding of N characters,
+/// unless N is a multiple of 4: whether such a field is padded is up to the
+/// caller, so M must be given, e.g. decode<24, 16> for a padded UUID.
+///
+/// The kernel is unrolled for N, so there is no length arithmetic, '=' trim
+/// loop or scalar tail at run time. Padding must be exactly as required for
+/// M bytes; non-zero bits of the final character are ignored.
+/// Throws invalid_input with the offending offset.
+///
+/// N is never deduced, so that string literals keep decoding into a
+/// std::string. A string literal of N characters (plus its terminating
+/// null character) is accepted as well.
+template <size_t N,
+          size_t M = detail::fixed::default_decoded_size(N),
+          std::enable_if_t<detail::fixed::has_decoded_size<N, M>, int> = 0>
+std::array<uint8_t, M> decode(typename detail::fixed::identity<char const (&)[N]>::type _input)
+{
+    return detail::fixed::decode<N, M>(_input);
+}
+
+template <size_t N,
+          size_t M = detail::fixed::default_decoded_size(N),
+          std::enable_if_t<detail::fixed::has_decoded_size<N, M>, int> = 0>
+std::array<uint8_t, M> decode(typename detail::fixed::identity<char const (&)[N + 1]>::type _input)
+{
+    return detail::fixed::decode<N, M>(_input);
+}
+
+#if defined(__cpp_lib_span)
+template <size_t N,
+          size_t M = detail::fixed::default_decoded_size(N),
+          std::enable_if_t<N != std::dynamic_extent && detail::fixed::has_decoded_size<N, M>, int> = 0>
+std::array<uint8_t, M> decode(std::span<char const, N> _input)
+{
+    return detail::fixed::decode<N, M>(_input.data());
+}
+#endif
+
+/// Encodes exactly @p M bytes, known at compile time, into encoded_size(M)
+/// characters including padding, with a kernel unrolled for M.
+template <size_t M>
+std::array<char, encoded_size(M)> encode(uint8_t const (&_input)[M])
+{
+    return detail::fixed::encode<M>(_input);
+}
+
+template <size_t M>
+std::array<char, encoded_size(M)> encode(std::array<uint8_t, M> const& _input)
+{
+    return detail::fixed::encode<M>(_input.data());
+}
+
+#if defined(__cpp_lib_span)
+template <size_t M, std::enable_if_t<M != std::dynamic_extent, int> = 0>
+std::array<char, encoded_size(M)> encode(std::span<uint8_t const, M> _input)
+{
+    return detail::fixed::encode<M>(_input.data());
+}
+#endif
+
+} // namespace base64
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/encode.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace base64
+{
+
+/// Framing of an encoded payload into escape sequences, such as OSC 52
+/// (one chunk) or the Kitty graphics protocol (chunks of at most 4096
+/// characters, the first carrying the control data):
+///
+///     framing kitty { "\033_Ga=T,f=100,m=1;", "\033_Gm=1;", "\033_Gm=0;", "\033\\", 4096 };
+///
+/// A payload that fits into a single chunk is framed by first_prefix alone;
+/// use chunk_count() to pick a first_prefix that announces no further chunks.
+struct framing
+{
+    std::string_view first_prefix; //!< before the first chunk
+    std::string_view prefix;       //!< before every chunk but the first and the last
+    std::string_view last_prefix;  //!< before the last chunk, if there is more than one
+    std::string_view suffix;       //!< after every chunk
+
+    /// Maximum number of payload characters per chunk, rounded down to a
+    /// multiple of 4 (at least 4), or 0 for a single chunk.
+    size_t chunk_size = 0;
+};
+
+namespace detail::encoder
+{
+    /// @returns the number of input bytes per chunk of @p _framing, or 0 for a single chunk.
+    constexpr size_t chunk_input_size(framing const& _framing) noexcept
+    {
+        return _framing.chunk_size ? (std::max(_framing.chunk_size, size_t(4)) / 4) * 3 : 0;
+    }
+
+    inline uint8_t* append(uint8_t* _output, std::string_view _text) noexcept
+    {
+        if (!_text.empty())
+            std::memcpy(_output, _text.data(), _text.size());
+        return _output + _text.size();
+    }
+}
+
+/// @returns the number of chunks that @p _size bytes are framed into; an
+///          empty payload still takes one (empty) chunk.
+constexpr size_t chunk_count(size_t _size, framing const& _framing) noexcept
+{
+    auto const chunkInputSize = detail::encoder::chunk_input_size(_framing);
+    if (!chunkInputSize || _size <= chunkInputSize)
+        return 1;
+    return (_size + chunkInputSize - 1) / chunkInputSize;
+}
+
+/// @returns the exact number of characters encode_framed() writes for @p _size bytes.
+constexpr size_t framed_size(size_t _size, framing const& _framing) noexcept
+{
+    auto const chunks = chunk_count(_size, _framing);
+    auto const prefixes = chunks == 1 ? _framing.first_prefix.size()
+                                      : _framing.first_prefix.size() + (chunks - 2) * _framing.prefix.size()
+                                            + _framing.last_prefix.size();
+    return encoded_size(_size) + prefixes + chunks * _framing.suffix.size();
+}
+
+/// Encodes @p _size bytes straight into the framed output @p _output, which
+/// must provide room for framed_size(_size, _framing) characters.
+///
+/// The payload of each chunk is written in place by the block kernel, so the
+/// whole reply is produced in a single pass without an intermediate copy.
+/// Only the last chunk is padded.
+///
+/// @returns number of characters written.
+inline size_t encode_framed(uint8_t const* _input, size_t _size, framing const& _framing, uint8_t* _output)
+{
+    auto const chunks = chunk_count(_size, _framing);
+    auto const chunkInputSize = chunks == 1 ? _size : detail::encoder::chunk_input_size(_framing);
+
+    uint8_t* out = _output;
+    for (size_t chunk = 0; chunk < chunks; ++chunk)
+    {
+        auto const& prefix = chunk == 0 ? _framing.first_prefix
+                             : chunk + 1 == chunks ? _framing.last_prefix
+                                                   : _framing.prefix;
+        auto const offset = chunk * chunkInputSize;
+        auto const size = std::min(chunkInputSize, _size - offset);
+
+        out = detail::encoder::append(out, prefix);
+        out += detail::encoder::encode_padded(_input + offset, size, out);
+        out = detail::encoder::append(out, _framing.suffix);
+    }
+
+    return static_cast<size_t>(out - _output);
+}
+
+/// Encodes @p _input into a single allocation of framed output.
+inline std::string encode_framed(std::string_view _input, framing const& _framing)
+{
+    std::string output;
+    output.resize(framed_size(_input.size(), _framing));
+    encode_framed(reinterpret_cast<uint8_t const*>(_input.data()),
+                  _input.size(),
+                  _framing,
+                  reinterpret_cast<uint8_t*>(output.data()));
+    return output;
+}
+
+} // namespace base64
@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+// Fused base64 decode and zlib inflate. Requires zlib: link the
+// base64-cpp::zlib target (CMake option BASE64_CPP_ZLIB).
+
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/sink.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <zlib.h>
+
+namespace base64
+{
+
+/// Thrown by inflate_decoder when the decoded data is not a valid compressed
+/// stream, with the zlib status code (Z_DATA_ERROR, Z_BUF_ERROR, ...).
+struct inflate_error final
+{
+    int const code;
+    char const* const message;
+};
+
+/// Output buffer of an inflate_decoder, into which the data is inflated
+/// directly, e.g. the pixel buffer of an image whose size is known.
+struct inflate_buffer
+{
+    uint8_t* data;
+    size_t capacity;
+    size_t size = 0; //!< number of bytes inflated so far
+};
+
+namespace detail::inflate
+{
+    /// Number of decoded (compressed) bytes handed to inflate() at once: a
+    /// multiple of 12, small enough to stay in cache between the two, and
+    /// large enough not to slow down inflate() by too frequent calls.
+    constexpr inline size_t chunk_size = 30 * 1024;
+
+    /// Number of inflated bytes per call of a sink.
+    constexpr inline size_t output_chunk_size = 32 * 1024;
+}
+
+/// Decodes a base64 payload of zlib compressed data and inflates it in the
+/// same pass, for payloads like Kitty graphics with o=z.
+///
+/// Blocks of 16 characters are decoded by the block kernel into a buffer of
+/// detail::inflate::chunk_size bytes, which is inflated right away, so that
+/// the compressed data never exists as a whole and stays in cache.
+///
+/// The payload may be split into any number of write() calls, e.g. one per
+/// escape sequence chunk, followed by a finish(). Padding is only accepted
+/// in the last 16 characters.
+///
+/// The output is either an inflate_buffer, written into directly, or a sink
+/// as for decode_to_sink(), invoked with chunks of at most
+/// detail::inflate::output_chunk_size bytes.
+///
+/// Throws invalid_input with the offset into the whole payload, or inflate_error.
+class inflate_decoder
+{
+  public:
+    /// @p _windowBits as for inflateInit2(): 15 for the zlib format,
+    /// -15 for raw deflate, 47 to detect the zlib and gzip formats.
+    explicit inflate_decoder(int _windowBits = MAX_WBITS):
+        decoded_ { std::make_unique<uint8_t[]>(detail::inflate::chunk_size) }
+    {
+        stream_.zalloc = Z_NULL;
+        stream_.zfree = Z_NULL;
+        stream_.opaque = Z_NULL;
+        stream_.next_in = Z_NULL;
+        stream_.avail_in = 0;
+        if (auto const status = inflateInit2(&stream_, _windowBits); status != Z_OK)
+            throw inflate_error { status, zError(status) };
+    }
+
+    // zlib's state refers back to the stream, which must therefore stay in place.
+    inflate_decoder(inflate_decoder const&) = delete;
+    inflate_decoder& operator=(inflate_decoder const&) = delete;
+
+    ~inflate_decoder() { inflateEnd(&stream_); }
+
+    /// Decodes and inflates the next characters @p _input of the payload.
+    /// Up to 16 characters are held back until the next write() or finish(),
+    /// as they may be the final, padded block.
+    template <typename Sink>
+    void write(std::string_view _input, Sink&& _sink)
+    {
+        if (carrySize_)
+        {
+            auto const n = std::min(sizeof(carry_) - carrySize_, _input.size());
+            std::memcpy(carry_ + carrySize_, _input.data(), n);
+            carrySize_ += n;
+            _input.remove_prefix(n);
+            if (_input.empty())
+                return;
+
+            decode_blocks(carry_, sizeof(carry_), _sink);
+            carrySize_ = 0;
+        }
+
+        if (_input.empty())
+            return;
+
+        auto const blocks = (_input.size() - 1) & ~size_t(15);
+        decode_blocks(_input.data(), blocks, _sink);
+        carrySize_ = _input.size() - blocks;
+        std::memcpy(carry_, _input.data() + blocks, carrySize_);
+
+        flush(_sink);
+    }
+
+    /// Decodes and inflates the rest of the payload, which must complete the
+    /// compressed stream.
+    ///
+    /// @returns the total number of inflated bytes.
+    template <typename Sink>
+    size_t finish(Sink&& _sink)
+    {
+        flush(_sink);
+
+        try
+        {
+            decodedSize_ = decode(std::string_view(reinterpret_cast<char const*>(carry_), carrySize_), decoded_.get());
+        }
+        catch (detail::decoder::invalid_input const& e)
+        {
+            throw detail::decoder::invalid_input { position_ + e.offset, e.byte };
+        }
+        position_ += carrySize_;
+        carrySize_ = 0;
+
+        flush(_sink);
+
+        if (!ended_)
+        {
+            if constexpr (std::is_same_v<std::decay_t<Sink>, inflate_buffer>)
+                if (_sink.size == _sink.capacity)
+                    throw inflate_error { Z_BUF_ERROR, "output buffer too small" };
+            throw inflate_error { Z_BUF_ERROR, "unexpected end of compressed data" };
+        }
+
+        return static_cast<size_t>(stream_.total_out);
+    }
+
+    /// @returns the number of characters decoded so far.
+    [[nodiscard]] size_t position() const noexcept { return position_; }
+
+  private:
+    /// Decodes @p _size characters (a multiple of 16) into the chunk buffer,
+    /// inflating it whenever it is full.
+    template <typename Sink>
+    void decode_blocks(void const* _input, size_t _size, Sink& _sink)
+    {
+        auto input = static_cast<uint8_t const*>(_input);
+        while (_size)
+        {
+            auto const room = ((detail::inflate::chunk_size - decodedSize_) / 12) * 16;
+            if (!room)
+            {
+                flush(_sink);
+                continue;
+            }
+
+            auto const n = std::min(room, _size);
+            try
+            {
+                decode(input, n, decoded_.get() + decodedSize_);
+            }
+            catch (detail::decoder::invalid_input const& e)
+            {
+                throw detail::decoder::invalid_input { position_ + e.offset, e.byte };
+            }
+            position_ += n;
+            decodedSize_ += (n / 4) * 3;
+            input += n;
+            _size -= n;
+        }
+    }
+
+    /// Inflates the decoded bytes of the chunk buffer into @p _sink.
+    template <typename Sink>
+    void flush(Sink& _sink)
+    {
+        if (!decodedSize_)
+            return;
+
+        if (ended_)
+            throw inflate_error { Z_DATA_ERROR, "data after the end of the compressed stream" };
+
+        constexpr bool isBuffer = std::is_same_v<std::decay_t<Sink>, inflate_buffer>;
+        if constexpr (!isBuffer)
+            if (!output_)
+                output_ = std::make_unique<uint8_t[]>(detail::inflate::output_chunk_size);
+
+        stream_.next_in = decoded_.get();
+        stream_.avail_in = static_cast<uInt>(decodedSize_);
+        decodedSize_ = 0;
+
+        do
+        {
+            uInt available = 0;
+            if constexpr (isBuffer)
+            {
+                available = static_cast<uInt>(std::min(_sink.capacity - _sink.size, size_t(UINT_MAX)));
+                stream_.next_out = _sink.data + _sink.size;
+            }
+            else
+            {
+                available = static_cast<uInt>(detail::inflate::output_chunk_size);
+                stream_.next_out = output_.get();
+            }
+            stream_.avail_out = available;
+
+            auto const status = ::inflate(&stream_, Z_NO_FLUSH);
+
+            auto const produced = static_cast<size_t>(available - stream_.avail_out);
+            if constexpr (isBuffer)
+                _sink.size += produced;
+            else if (produced)
+                detail::emit(_sink, output_.get(), produced);
+
+            if (status == Z_STREAM_END)
+            {
+                ended_ = true;
+                if (stream_.avail_in)
+                    throw inflate_error { Z_DATA_ERROR, "data after the end of the compressed stream" };
+                break;
+            }
+
+            if (status == Z_BUF_ERROR)
+            {
+                // no progress: either all input is consumed or the output buffer is full
+                if (stream_.avail_in)
+                    throw inflate_error { Z_BUF_ERROR, "output buffer too small" };
+                break;
+            }
+
+            if (status != Z_OK)
+                throw inflate_error { status, stream_.msg ? stream_.msg : zError(status) };
+        } while (stream_.avail_in || !stream_.avail_out);
+    }
+
+    z_stream stream_ {};
+    std::unique_ptr<uint8_t[]> decoded_;
+    std::unique_ptr<uint8_t[]> output_;
+    size_t decodedSize_ = 0;
+    uint8_t carry_[16] {};
+    size_t carrySize_ = 0;
+    size_t position_ = 0;
+    bool ended_ = false;
+};
+
+/// Decodes and inflates the whole payload @p _input straight into @p _output,
+/// which must provide room for all of the inflated data.
+///
+/// @returns the number of inflated bytes.
+inline size_t decode_inflate(std::string_view _input, uint8_t* _output, size_t _capacity)
+{
+    inflate_decoder decoder;
+    inflate_buffer buffer { _output, _capacity };
+    decoder.write(_input, buffer);
+    return decoder.finish(buffer);
+}
+
+/// Decodes and inflates the whole payload @p _input into a string.
+inline std::string decode_inflate(std::string_view _input)
+{
+    std::string output;
+    auto const append = [&](uint8_t const* _data, size_t _size) {
+        output.append(reinterpret_cast<char const*>(_data), _size);
+    };
+
+    inflate_decoder decoder;
+    decoder.write(_input, append);
+    decoder.finish(append);
+    return output;
+}
+
+} // namespace base64
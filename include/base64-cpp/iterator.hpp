@@ -0,0 +1,336 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/encode.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace base64::detail::iterator
+{
+
+/// Characters or bytes of the generic decode() and encode() are staged in
+/// blocks of this many characters when either side is not contiguous.
+constexpr inline size_t staging_size = 4096;
+
+template <typename T>
+constexpr bool is_byte_like_v = std::is_same_v<T, char> || std::is_same_v<T, signed char>
+                                || std::is_same_v<T, unsigned char> || std::is_same_v<T, std::byte>
+#if defined(__cpp_char8_t)
+                                || std::is_same_v<T, char8_t>
+#endif
+    ;
+
+template <typename It>
+using value_t = std::remove_cv_t<typename std::iterator_traits<It>::value_type>;
+
+template <typename It, typename = void>
+struct is_byte_iterator: std::false_type
+{
+};
+
+template <typename It>
+struct is_byte_iterator<It, std::void_t<typename std::iterator_traits<It>::value_type>>:
+    std::bool_constant<is_byte_like_v<value_t<It>>>
+{
+};
+
+template <typename It>
+constexpr bool is_byte_iterator_v = is_byte_iterator<It>::value;
+
+/// Contiguity cannot be queried before C++20, so besides pointers, the
+/// iterators of std::vector and std::string are recognized by type.
+/// std::array and std::string_view iterators are pointers in libstdc++ and libc++.
+template <typename It>
+constexpr bool is_contiguous_iterator() noexcept
+{
+    using V = value_t<It>;
+
+    if constexpr (std::is_pointer_v<It>)
+        return true;
+#if defined(__cpp_lib_concepts)
+    else if constexpr (std::contiguous_iterator<It>)
+        return true;
+#endif
+    else if constexpr (std::is_same_v<It, typename std::vector<V>::iterator>
+                       || std::is_same_v<It, typename std::vector<V>::const_iterator>)
+        return true;
+    else if constexpr (std::is_same_v<V, char>)
+        return std::is_same_v<It, std::string::iterator> || std::is_same_v<It, std::string::const_iterator>;
+    else
+        return false;
+}
+
+/// Iterators over contiguous bytes, which are passed to the kernels as pointers.
+template <typename It>
+constexpr bool is_contiguous_bytes_v = [] {
+    if constexpr (is_byte_iterator_v<It>)
+        return is_contiguous_iterator<It>();
+    else
+        return false;
+}();
+
+template <typename It>
+auto address(It _it) noexcept
+{
+#if defined(__cpp_lib_to_address)
+    return std::to_address(_it);
+#else
+    if constexpr (std::is_pointer_v<It>)
+        return _it;
+    else
+        return std::addressof(*_it);
+#endif
+}
+
+template <typename T>
+struct type_is
+{
+    using type = T;
+};
+
+template <typename It>
+auto output_value_of(int) -> type_is<typename It::container_type::value_type>; // std::back_insert_iterator
+
+template <typename It>
+auto output_value_of(long) -> type_is<typename It::char_type>; // std::ostreambuf_iterator
+
+template <typename It>
+auto output_value_of(...) -> type_is<uint8_t>;
+
+template <typename It, typename = void>
+struct output_value
+{
+    using type = typename decltype(output_value_of<It>(0))::type;
+};
+
+template <typename It>
+struct output_value<It, std::enable_if_t<!std::is_void_v<typename std::iterator_traits<It>::value_type>>>
+{
+    using type = value_t<It>;
+};
+
+/// Type that bytes are converted into when assigned through an output iterator.
+template <typename It>
+using output_value_t = typename output_value<It>::type;
+
+/// Writes @p _size bytes to @p _out.
+/// @returns the iterator past the last byte written.
+template <typename OutputIt>
+OutputIt put(uint8_t const* _data, size_t _size, OutputIt _out)
+{
+    if constexpr (is_contiguous_bytes_v<OutputIt>)
+    {
+        if (_size)
+            std::memcpy(address(_out), _data, _size);
+        return _out + static_cast<std::ptrdiff_t>(_size);
+    }
+    else
+    {
+        for (size_t i = 0; i < _size; ++i)
+        {
+            *_out = static_cast<output_value_t<OutputIt>>(_data[i]);
+            ++_out;
+        }
+        return _out;
+    }
+}
+
+/// Decodes @p _size characters (a multiple of 16) with the block kernel of @p Mode,
+/// staging the bytes before writing them to @p _out.
+///
+/// invalid_input is thrown with offsets relative to @p _offset.
+template <decode_mode Mode, typename OutputIt>
+OutputIt decode_blocks(char const* _input, size_t _size, OutputIt _out, size_t _offset)
+{
+    uint8_t bytes[(staging_size / 4) * 3];
+    for (size_t i = 0; i < _size; i += staging_size)
+    {
+        auto const n = std::min(staging_size, _size - i);
+        auto const input = reinterpret_cast<uint8_t const*>(_input + i);
+        try
+        {
+            if constexpr (Mode == decode_mode::trusted)
+                decoder::decode_trusted(input, n, bytes);
+            else
+                base64::decode(input, n, bytes);
+        }
+        catch (decoder::invalid_input const& e)
+        {
+            throw decoder::invalid_input{_offset + i + e.offset, e.byte};
+        }
+        _out = put(bytes, (n / 4) * 3, _out);
+    }
+    return _out;
+}
+
+/// Decodes all of @p _input like decode<Mode>(std::string_view, uint8_t*),
+/// staging the bytes before writing them to @p _out.
+///
+/// Everything but the last staging_size characters before the trailing '='
+/// goes to the block kernel, in the same 16 character grid as decode() uses.
+template <decode_mode Mode, typename OutputIt>
+OutputIt decode_staged(std::string_view _input, OutputIt _out, size_t _offset)
+{
+    auto const end = _input.find_last_not_of('=') + 1;
+    auto const blocks = end > staging_size ? (end - staging_size + 15) & ~size_t(15) : 0;
+    _out = decode_blocks<Mode>(_input.data(), blocks, _out, _offset);
+
+    // At most staging_size characters other than '=' are left, unless there
+    // are more than 16 '=', which only a lenient decode() accepts as padding.
+    auto const rest = _input.substr(blocks);
+    try
+    {
+        if (rest.size() > staging_size + 16)
+        {
+            auto const bytes = decode<Mode>(rest);
+            return put(reinterpret_cast<uint8_t const*>(bytes.data()), bytes.size(), _out);
+        }
+
+        uint8_t bytes[((staging_size + 16) / 4) * 3];
+        return put(bytes, decode<Mode>(rest, bytes), _out);
+    }
+    catch (decoder::invalid_input const& e)
+    {
+        throw decoder::invalid_input{_offset + blocks + e.offset, e.byte};
+    }
+}
+
+} // namespace base64::detail::iterator
+
+namespace base64
+{
+
+/// Decodes the characters in [_first, _last) into @p _out, like
+/// decode<Mode>(std::string_view, uint8_t*).
+///
+/// The value type of the input is one of char, signed char, unsigned char,
+/// std::byte and char8_t. Pointers and the iterators of std::vector and
+/// std::string (and any std::contiguous_iterator in C++20) are passed to the
+/// SIMD kernels directly, as is a contiguous output of the same value types.
+/// Other iterators, including single pass ones, are staged through a buffer
+/// of detail::iterator::staging_size characters.
+///
+/// @p _out must accept at least (3 * n) / 4 bytes, n being the input size.
+///
+/// @returns the iterator past the last byte written.
+template <decode_mode Mode = decode_mode::lenient,
+          typename InputIt,
+          typename OutputIt,
+          std::enable_if_t<detail::iterator::is_byte_iterator_v<InputIt>, int> = 0>
+OutputIt decode(InputIt _first, InputIt _last, OutputIt _out)
+{
+    using namespace detail::iterator;
+
+    if constexpr (is_contiguous_bytes_v<InputIt>)
+    {
+        if (_first == _last)
+            return _out;
+
+        auto const input =
+            std::string_view(reinterpret_cast<char const*>(address(_first)), static_cast<size_t>(_last - _first));
+
+        if constexpr (is_contiguous_bytes_v<OutputIt>)
+        {
+            // nothing is written, but the input is validated all the same
+            uint8_t none[1];
+            if (input.size() < 2)
+                return _out + static_cast<std::ptrdiff_t>(decode<Mode>(input, none));
+
+            return _out + static_cast<std::ptrdiff_t>(decode<Mode>(input, reinterpret_cast<uint8_t*>(address(_out))));
+        }
+        else
+            return decode_staged<Mode>(input, _out, 0);
+    }
+    else
+    {
+        // Whole blocks are decoded whenever the buffer is full, unless it ends
+        // in '=', which may be the padding; the rest is decoded as a whole.
+        std::string pending;
+        pending.reserve(staging_size);
+        size_t offset = 0;
+
+        for (; _first != _last; ++_first)
+        {
+            pending.push_back(static_cast<char>(*_first));
+            if (pending.size() >= staging_size && pending.back() != '=')
+            {
+                auto const blocks = (pending.size() - 1) & ~size_t(15);
+                _out = decode_blocks<Mode>(pending.data(), blocks, _out, offset);
+                pending.erase(0, blocks);
+                offset += blocks;
+            }
+        }
+
+        return decode_staged<Mode>(pending, _out, offset);
+    }
+}
+
+/// Encodes the bytes in [_first, _last) into @p _out, including padding.
+///
+/// The value type of the input is one of char, signed char, unsigned char,
+/// std::byte and char8_t. As for the generic decode(), contiguous input and
+/// output are passed to the SIMD kernels directly, and anything else is
+/// staged through a buffer.
+///
+/// @p _out must accept at least encoded_size(n) characters.
+///
+/// @returns the iterator past the last character written.
+template <typename InputIt,
+          typename OutputIt,
+          std::enable_if_t<detail::iterator::is_byte_iterator_v<InputIt>, int> = 0>
+OutputIt encode(InputIt _first, InputIt _last, OutputIt _out)
+{
+    using namespace detail::iterator;
+
+    constexpr size_t chunkSize = (staging_size / 4) * 3;
+
+    if constexpr (is_contiguous_bytes_v<InputIt>)
+    {
+        if (_first == _last)
+            return _out;
+
+        auto const input = reinterpret_cast<uint8_t const*>(address(_first));
+        auto const size = static_cast<size_t>(_last - _first);
+
+        if constexpr (is_contiguous_bytes_v<OutputIt>)
+        {
+            return _out + static_cast<std::ptrdiff_t>(
+                       detail::encoder::encode_padded(input, size, reinterpret_cast<uint8_t*>(address(_out))));
+        }
+        else
+        {
+            uint8_t chars[staging_size];
+            for (size_t i = 0; i < size; i += chunkSize)
+                _out = put(chars, detail::encoder::encode_padded(input + i, std::min(chunkSize, size - i), chars), _out);
+            return _out;
+        }
+    }
+    else
+    {
+        uint8_t bytes[chunkSize];
+        uint8_t chars[staging_size];
+        size_t size = 0;
+        for (; _first != _last; ++_first)
+        {
+            bytes[size++] = static_cast<uint8_t>(*_first);
+            if (size == chunkSize)
+            {
+                _out = put(chars, detail::encoder::encode_padded(bytes, size, chars), _out);
+                size = 0;
+            }
+        }
+        return put(chars, detail::encoder::encode_padded(bytes, size, chars), _out);
+    }
+}
+
+} // namespace base64
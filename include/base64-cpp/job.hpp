@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/decode.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+    #include <coroutine>
+    #include <exception>
+    #include <iterator>
+    #include <utility>
+    #define BASE64_CPP_COROUTINES 1
+#endif
+
+namespace base64
+{
+
+/// Number of bytes that decode_job::step(deadline) decodes between two looks
+/// at the clock: about 5 to 10 microseconds with a SIMD kernel.
+constexpr inline size_t decode_job_slice_size = 48 * 1024;
+
+/// Resumable decode of @p _input into @p _output, for callers that must not
+/// block for the duration of a large decode(), such as a render thread that
+/// interleaves the decode of an image with drawing frames:
+///
+///     decode_job job(payload, pixels);
+///     while (!job.step(clock::now() + 2ms))
+///         renderFrame();
+///
+/// Every step() decodes whole blocks of 16 characters with the block kernel,
+/// in the same grid as decode<Mode>(std::string_view, uint8_t*), and the
+/// final block together with its padding, so that the output and the errors
+/// are exactly those of a single decode<Mode>() call.
+///
+/// An invalid character does not throw, but finishes the job with error()
+/// set to the offset into the whole input; the bytes before the invalid
+/// block have been written by then.
+///
+/// The input and output must stay alive and unmodified until the job is done.
+template <decode_mode Mode = decode_mode::lenient>
+class decode_job
+{
+  public:
+    /// @p _output must provide room for at least (3 * _input.size()) / 4 bytes.
+    decode_job(std::string_view _input, uint8_t* _output) noexcept:
+        input_ { _input },
+        output_ { _output },
+        blocks_ { blocks_size(_input) }
+    {
+    }
+
+    /// Decodes at most @p _byteBudget bytes, rounded down to whole blocks of
+    /// 12 bytes (one block at least), and the final block once all other
+    /// blocks are done.
+    ///
+    /// @returns true if the job is done, successfully or not.
+    bool step(size_t _byteBudget)
+    {
+        if (done_)
+            return true;
+
+        try
+        {
+            auto const size = std::min(std::max(_byteBudget / 12, size_t(1)), (blocks_ - position_) / 16) * 16;
+            if (size)
+            {
+                decode_blocks(position_, size);
+                position_ += size;
+                written_ += (size / 4) * 3;
+            }
+
+            if (position_ == blocks_)
+            {
+                written_ += decode_rest();
+                position_ = input_.size();
+                done_ = true;
+            }
+        }
+        catch (detail::decoder::invalid_input const& e)
+        {
+            error_.emplace(detail::decoder::invalid_input{position_ + e.offset, e.byte});
+            done_ = true;
+        }
+
+        return done_;
+    }
+
+    /// Decodes slices of decode_job_slice_size bytes until @p _deadline has
+    /// passed (after one slice at least) or the job is done.
+    ///
+    /// @returns true if the job is done, successfully or not.
+    template <typename Clock, typename Duration>
+    bool step(std::chrono::time_point<Clock, Duration> _deadline)
+    {
+        while (!step(decode_job_slice_size))
+            if (Clock::now() >= _deadline)
+                return false;
+        return true;
+    }
+
+    /// Decodes everything that is left; the equivalent of a decode() call.
+    bool run() { return step(input_.size()); }
+
+    [[nodiscard]] bool done() const noexcept { return done_; }
+
+    /// @returns the offset and value of the invalid character that stopped the job, if any.
+    [[nodiscard]] std::optional<detail::decoder::invalid_input> const& error() const noexcept { return error_; }
+
+    /// @returns the number of characters decoded so far.
+    [[nodiscard]] size_t position() const noexcept { return position_; }
+
+    /// @returns the number of bytes written so far.
+    [[nodiscard]] size_t bytes_written() const noexcept { return written_; }
+
+  private:
+    /// @returns the size of the leading whole blocks, leaving between 1 and 16
+    ///          characters before the trailing '=' to decode_rest().
+    static size_t blocks_size(std::string_view _input) noexcept
+    {
+        auto const end = _input.find_last_not_of('=') + 1;
+        return end ? (end - 1) & ~size_t(15) : 0;
+    }
+
+    void decode_blocks(size_t _offset, size_t _size)
+    {
+        auto const input = reinterpret_cast<uint8_t const*>(input_.data() + _offset);
+        if constexpr (Mode == decode_mode::trusted)
+            detail::decoder::decode_trusted(input, _size, output_ + written_);
+        else
+            base64::decode(input, _size, output_ + written_);
+    }
+
+    size_t decode_rest() { return decode<Mode>(input_.substr(blocks_), output_ + written_); }
+
+    std::string_view input_;
+    uint8_t* output_;
+    size_t blocks_;
+    size_t position_ = 0;
+    size_t written_ = 0;
+    bool done_ = false;
+    std::optional<detail::decoder::invalid_input> error_;
+};
+
+#if defined(BASE64_CPP_COROUTINES)
+
+/// Generator of the slices of a decode_job (C++20), see decode_slices().
+class decode_slice_generator
+{
+  public:
+    struct promise_type
+    {
+        size_t value = 0;
+        std::exception_ptr exception;
+
+        decode_slice_generator get_return_object() noexcept
+        {
+            return decode_slice_generator { std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(size_t _value) noexcept
+        {
+            value = _value;
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+    };
+
+    class iterator
+    {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = size_t const*;
+        using reference = size_t const&;
+
+        iterator() noexcept = default;
+        explicit iterator(std::coroutine_handle<promise_type> _coroutine) noexcept: coroutine_ { _coroutine } {}
+
+        reference operator*() const noexcept { return coroutine_.promise().value; }
+
+        iterator& operator++()
+        {
+            resume(coroutine_);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(iterator const& a, std::default_sentinel_t) noexcept { return a.coroutine_.done(); }
+
+      private:
+        std::coroutine_handle<promise_type> coroutine_;
+    };
+
+    decode_slice_generator(decode_slice_generator&& _other) noexcept:
+        coroutine_ { std::exchange(_other.coroutine_, {}) }
+    {
+    }
+    decode_slice_generator& operator=(decode_slice_generator&&) = delete;
+    ~decode_slice_generator()
+    {
+        if (coroutine_)
+            coroutine_.destroy();
+    }
+
+    iterator begin()
+    {
+        resume(coroutine_);
+        return iterator { coroutine_ };
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+  private:
+    explicit decode_slice_generator(std::coroutine_handle<promise_type> _coroutine) noexcept:
+        coroutine_ { _coroutine }
+    {
+    }
+
+    static void resume(std::coroutine_handle<promise_type> _coroutine)
+    {
+        _coroutine.resume();
+        if (_coroutine.promise().exception)
+            std::rethrow_exception(_coroutine.promise().exception);
+    }
+
+    std::coroutine_handle<promise_type> coroutine_;
+};
+
+/// Runs @p _job slice by slice (C++20), yielding the number of bytes written
+/// after every slice of at most @p _byteBudget bytes, so that a caller can
+/// do other work in between:
+///
+///     for ([[maybe_unused]] auto written: decode_slices(job, 256 * 1024))
+///         renderFrame();
+///
+/// The job must outlive the generator. The generator ends when the job is
+/// done; check job.error() afterwards.
+template <decode_mode Mode>
+decode_slice_generator decode_slices(decode_job<Mode>& _job, size_t _byteBudget = decode_job_slice_size)
+{
+    while (!_job.step(_byteBudget))
+        co_yield _job.bytes_written();
+    co_yield _job.bytes_written();
+}
+
+#endif
+
+} // namespace base64
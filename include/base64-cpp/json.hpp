@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/detail/dispatch.hpp>
+#include <base64-cpp/terminator.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace base64::detail::decoder
+{
+
+/// JSON string decoding kernel, see sse::decode_json_prefix().
+using json_kernel_fn = json_prefix (*)(uint8_t const* _input, size_t _size, uint8_t* _output);
+
+/// All JSON string decoding kernels, ordered from best to worst.
+inline constexpr std::array json_kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<json_kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &sse::decode_json_prefix},
+#endif
+    dispatch::kernel<json_kernel_fn>{"simple", 0, &simple::decode_json_prefix},
+};
+
+inline json_kernel_fn& selected_json_kernel() noexcept
+{
+    static json_kernel_fn kernel = dispatch::select(json_kernels);
+    return kernel;
+}
+
+}
+
+namespace base64
+{
+
+/// Decodes the base64 payload of a JSON string, @p _input starting right after
+/// its opening quote, up to the closing quote, without unescaping it first.
+///
+/// "\/" is decoded as '/', which JSON encoders may escape. Blocks of 16
+/// characters without a backslash are decoded at the speed of decode(), the
+/// others are compacted within the vector loop (see sse::decode_json_prefix()).
+/// The payload may end with '=' padding, which is consumed. Like decode(), an
+/// incomplete final group is decoded leniently.
+///
+/// The reason is stop_reason::terminator for the closing quote, and
+/// chars_consumed its offset in @p _input. Any other escape sequence, or
+/// character outside the alphabet, stops with stop_reason::invalid at its offset.
+///
+/// @p _output must provide room for at least (3 * _input.size()) / 4 bytes.
+inline decode_until_result decode_json_string(std::string_view _input, uint8_t* _output)
+{
+    using detail::decoder::simple::alphabetIndexMap;
+
+    auto const input = reinterpret_cast<uint8_t const*>(_input.data());
+    auto const prefix = detail::decoder::selected_json_kernel()(input, _input.size(), _output);
+
+    // The rest, from the block of the stop on, is decoded by the scalar loop,
+    // continuing with the values that the kernel has not decoded yet.
+    uint8_t* out = _output + prefix.written;
+    uint8_t values[4];
+    size_t count = 0;
+    auto const push = [&](uint8_t _value) {
+        values[count++] = _value;
+        if (count == 4)
+        {
+            *out++ = static_cast<uint8_t>(values[0] << 2 | values[1] >> 4);
+            *out++ = static_cast<uint8_t>(values[1] << 4 | values[2] >> 2);
+            *out++ = static_cast<uint8_t>(values[2] << 6 | values[3]);
+            count = 0;
+        }
+    };
+
+    for (size_t i = 0; i < prefix.count; ++i)
+        push(prefix.values[i]);
+
+    auto stop = prefix.position;
+    while (stop < _input.size())
+    {
+        if (input[stop] == '\\' && stop + 1 < _input.size() && input[stop + 1] == '/')
+        {
+            push(63);
+            stop += 2;
+        }
+        else if (alphabetIndexMap[input[stop]] <= 63)
+            push(alphabetIndexMap[input[stop++]]);
+        else
+            break;
+    }
+
+    if (count >= 2)
+        *out++ = static_cast<uint8_t>(values[0] << 2 | values[1] >> 4);
+    if (count == 3)
+        *out++ = static_cast<uint8_t>(values[1] << 4 | values[2] >> 2);
+
+    while (stop < _input.size() && input[stop] == '=')
+        ++stop;
+
+    auto const bytesWritten = static_cast<size_t>(out - _output);
+    if (stop == _input.size())
+        return {bytesWritten, stop, stop_reason::end_of_input};
+    if (input[stop] == '"')
+        return {bytesWritten, stop, stop_reason::terminator};
+    return {bytesWritten, stop, stop_reason::invalid};
+}
+
+} // namespace base64
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/detail/dispatch.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace base64::detail::decoder
+{
+
+/// RGB24 to RGBA32 decoding kernel: decodes @p _size characters (a multiple of 16)
+/// into (_size / 4) RGBA pixels with the constant alpha value @p _alpha.
+using rgba_kernel_fn = void (*)(uint8_t const* _input, size_t _size, uint8_t* _output, uint8_t _alpha);
+
+inline void decode_rgb_to_rgba_simple(uint8_t const* _input, size_t _size, uint8_t* _output, uint8_t _alpha)
+{
+    for (size_t i = 0; i < _size; i += 4)
+    {
+        try
+        {
+            simple::decode_blocks(_input + i, 4, _output);
+        }
+        catch (invalid_input const& e)
+        {
+            throw invalid_input{i + e.offset, e.byte};
+        }
+        _output[3] = _alpha;
+        _output += 4;
+    }
+}
+
+/// All RGB24 to RGBA32 decoding kernels, ordered from best to worst.
+inline constexpr std::array rgba_kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<rgba_kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &sse::decode_rgb_to_rgba_pshufb_madd},
+#endif
+    dispatch::kernel<rgba_kernel_fn>{"simple", 0, &decode_rgb_to_rgba_simple},
+};
+
+inline rgba_kernel_fn& selected_rgba_kernel() noexcept
+{
+    static rgba_kernel_fn kernel = dispatch::select(rgba_kernels);
+    return kernel;
+}
+
+}
+
+namespace base64
+{
+
+/// Pixel layout of the decoded (binary) payload.
+enum class pixel_format
+{
+    rgb24,  //!< 3 bytes per pixel: R, G, B
+    rgba32, //!< 4 bytes per pixel: R, G, B, A
+};
+
+/// Decodes base64 encoded pixel data of layout @p _format directly into
+/// RGBA32 pixels at @p _output, avoiding an intermediate byte buffer.
+///
+/// RGB24 pixels are expanded to RGBA32 with the constant alpha value @p _alpha,
+/// RGBA32 pixels are passed through as is.
+/// A trailing incomplete pixel is ignored.
+///
+/// @p _output must provide room for at least _input.size() bytes.
+///
+/// @returns number of pixels written.
+inline size_t decode_pixels(std::string_view _input, pixel_format _format, uint8_t* _output, uint8_t _alpha = 0xff)
+{
+    if (_format == pixel_format::rgba32)
+        return decode(_input, _output) / 4;
+
+    while (!_input.empty() && _input.back() == '=')
+        _input.remove_suffix(1);
+
+    auto const mainInputLength = _input.size() & ~size_t(15);
+    size_t pixelCount = mainInputLength / 4;
+    if (mainInputLength)
+    {
+        detail::decoder::selected_rgba_kernel()(reinterpret_cast<uint8_t const*>(_input.data()),
+                                                mainInputLength,
+                                                _output,
+                                                _alpha);
+        _input.remove_prefix(mainInputLength);
+    }
+
+    if (!_input.empty())
+    {
+        uint8_t rgb[12];
+        auto const tailLength = detail::decoder::simple::decode(_input.begin(), _input.end(), rgb);
+        for (size_t i = 0; i + 3 <= tailLength; i += 3)
+        {
+            uint8_t* pixel = _output + 4 * pixelCount++;
+            pixel[0] = rgb[i + 0];
+            pixel[1] = rgb[i + 1];
+            pixel[2] = rgb[i + 2];
+            pixel[3] = _alpha;
+        }
+    }
+
+    return pixelCount;
+}
+
+} // namespace base64
@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/encode.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace base64::detail::scatter
+{
+
+template <typename T, typename = void>
+struct is_iovec: std::false_type
+{
+};
+
+template <typename T>
+struct is_iovec<T, std::void_t<decltype(std::declval<T&>().iov_base), decltype(std::declval<T&>().iov_len)>>:
+    std::true_type
+{
+};
+
+template <typename T, typename = void>
+struct is_contiguous: std::false_type
+{
+};
+
+template <typename T>
+struct is_contiguous<T, std::void_t<decltype(std::data(std::declval<T&>())), decltype(std::size(std::declval<T&>()))>>:
+    std::bool_constant<sizeof(*std::data(std::declval<T&>())) == 1>
+{
+};
+
+/// A segment is a struct iovec or a contiguous range of bytes, such as
+/// std::string_view or std::span<uint8_t>.
+template <typename T>
+constexpr bool is_segment_v = is_iovec<T>::value || is_contiguous<T>::value;
+
+template <typename T, typename = void>
+struct is_segment_range: std::false_type
+{
+};
+
+template <typename T>
+struct is_segment_range<T, std::void_t<decltype(std::begin(std::declval<T&>()))>>:
+    std::bool_constant<is_segment_v<std::remove_reference_t<decltype(*std::begin(std::declval<T&>()))>>>
+{
+};
+
+template <typename T>
+constexpr bool is_segment_range_v = is_segment_range<std::remove_reference_t<T>>::value;
+
+template <typename Segment>
+std::pair<uint8_t const*, size_t> input_segment(Segment const& _segment) noexcept
+{
+    if constexpr (is_iovec<Segment const>::value)
+        return {static_cast<uint8_t const*>(_segment.iov_base), _segment.iov_len};
+    else
+        return {reinterpret_cast<uint8_t const*>(std::data(_segment)), std::size(_segment)};
+}
+
+template <typename Segment>
+std::pair<uint8_t*, size_t> output_segment(Segment& _segment) noexcept
+{
+    if constexpr (is_iovec<Segment>::value)
+        return {static_cast<uint8_t*>(_segment.iov_base), _segment.iov_len};
+    else
+        return {reinterpret_cast<uint8_t*>(std::data(_segment)), std::size(_segment)};
+}
+
+/// Sequential writer over a range of output segments.
+template <typename Iterator, typename Sentinel>
+class writer
+{
+  public:
+    writer(Iterator _begin, Sentinel _end): current_ { _begin }, end_ { _end } { next(); }
+
+    /// @returns contiguous room left in the current segment.
+    size_t room() const noexcept { return size_; }
+
+    uint8_t* data() const noexcept { return data_; }
+
+    /// @returns the number of bytes written so far.
+    size_t written() const noexcept { return written_; }
+
+    void advance(size_t _count) noexcept
+    {
+        data_ += _count;
+        size_ -= _count;
+        written_ += _count;
+        if (!size_)
+            next();
+    }
+
+    /// Copies @p _count bytes, spanning as many segments as required, and
+    /// drops those for which the segments have no room left.
+    void write(uint8_t const* _data, size_t _count) noexcept
+    {
+        while (_count && size_)
+        {
+            auto const n = std::min(_count, size_);
+            std::memcpy(data_, _data, n);
+            _data += n;
+            _count -= n;
+            advance(n);
+        }
+    }
+
+  private:
+    void next() noexcept
+    {
+        while (!size_ && current_ != end_)
+            std::tie(data_, size_) = output_segment(*current_++);
+    }
+
+    Iterator current_;
+    Sentinel end_;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t written_ = 0;
+};
+
+/// Runs @p _kernel over the first @p _length bytes of the concatenated input
+/// segments in blocks of InBlock bytes, each producing OutBlock bytes.
+///
+/// Blocks are aligned to the start of the concatenated input, exactly as for
+/// contiguous input. Blocks that straddle an input segment boundary are
+/// stitched in a small buffer, and blocks whose output would straddle an
+/// output segment boundary are written through one; everything else is
+/// processed in place, as many blocks per kernel call as possible.
+///
+/// @returns the offset of the remaining, incomplete block, which has been
+///          copied to @p _carry.
+template <size_t InBlock, size_t OutBlock, typename Input, typename Writer, typename Kernel>
+size_t transform(Input const& _input, size_t _length, Writer& _output, Kernel _kernel, uint8_t (&_carry)[InBlock])
+{
+    uint8_t block[OutBlock];
+    size_t offset = 0;
+    size_t carried = 0;
+
+    for (auto const& segment: _input)
+    {
+        if (offset + carried == _length)
+            break;
+
+        auto [data, size] = input_segment(segment);
+        size = std::min(size, _length - offset - carried);
+
+        if (carried)
+        {
+            auto const n = std::min(size, InBlock - carried);
+            std::memcpy(_carry + carried, data, n);
+            carried += n;
+            data += n;
+            size -= n;
+
+            if (carried < InBlock)
+                continue;
+
+            _kernel(_carry, InBlock, block, offset);
+            _output.write(block, OutBlock);
+            offset += InBlock;
+            carried = 0;
+        }
+
+        while (size >= InBlock)
+        {
+            auto const blocks = std::min(size / InBlock, _output.room() / OutBlock);
+            if (blocks)
+            {
+                _kernel(data, blocks * InBlock, _output.data(), offset);
+                _output.advance(blocks * OutBlock);
+            }
+            else
+            {
+                _kernel(data, InBlock, block, offset);
+                _output.write(block, OutBlock);
+            }
+
+            auto const n = std::max(blocks, size_t(1)) * InBlock;
+            data += n;
+            size -= n;
+            offset += n;
+        }
+
+        std::memcpy(_carry, data, size);
+        carried = size;
+    }
+
+    return offset;
+}
+
+} // namespace base64::detail::scatter
+
+namespace base64
+{
+
+/// Decodes the concatenation of the input segments @p _input into the
+/// concatenation of the output segments @p _output, without gathering them
+/// into a contiguous buffer first. Segments are struct iovec or contiguous
+/// ranges of bytes, e.g. the two halves of a ring buffer.
+///
+/// Behaves like the lenient decode(std::string_view, uint8_t*): any number
+/// of trailing '=' is accepted, and invalid_input is thrown with the offset
+/// into the concatenated input.
+///
+/// The output segments must provide room for at least (3 * n) / 4 bytes in
+/// total, n being the total input size. If they do not, the output stops at
+/// their end, which the returned count tells.
+///
+/// @returns number of bytes written.
+template <typename InputSegments,
+          typename OutputSegments,
+          std::enable_if_t<detail::scatter::is_segment_range_v<InputSegments>
+                               && detail::scatter::is_segment_range_v<OutputSegments>,
+                           int> = 0>
+size_t decode(InputSegments const& _input, OutputSegments&& _output)
+{
+    // Trailing '=' may itself be split across segments.
+    size_t length = 0;
+    size_t padding = 0;
+    for (auto const& segment: _input)
+    {
+        auto const [data, size] = detail::scatter::input_segment(segment);
+        auto n = size;
+        while (n && data[n - 1] == '=')
+            --n;
+        padding = n ? size - n : padding + size;
+        length += size;
+    }
+    length -= padding;
+
+    auto writer = detail::scatter::writer(std::begin(_output), std::end(_output));
+    auto const kernel = [](uint8_t const* _in, size_t _size, uint8_t* _out, size_t _offset) {
+        try
+        {
+            decode(_in, _size, _out);
+        }
+        catch (detail::decoder::invalid_input const& e)
+        {
+            throw detail::decoder::invalid_input{_offset + e.offset, e.byte};
+        }
+    };
+
+    uint8_t carry[16];
+    auto const offset = detail::scatter::transform<16, 12>(_input, length, writer, kernel, carry);
+
+    uint8_t tail[12];
+    auto const tailLength = detail::decoder::simple::decode(carry, carry + (length - offset), tail);
+    writer.write(tail, tailLength);
+
+    return writer.written();
+}
+
+/// Encodes the concatenation of the input segments @p _input into the
+/// concatenation of the output segments @p _output, including padding.
+/// Segments are struct iovec or contiguous ranges of bytes, so that the
+/// output can be passed to writev() directly.
+///
+/// The output segments must provide room for at least encoded_size(n)
+/// characters in total, n being the total input size. If they do not, the
+/// output stops at their end, which the returned count tells.
+///
+/// @returns number of characters written.
+template <typename InputSegments,
+          typename OutputSegments,
+          std::enable_if_t<detail::scatter::is_segment_range_v<InputSegments>
+                               && detail::scatter::is_segment_range_v<OutputSegments>,
+                           int> = 0>
+size_t encode(InputSegments const& _input, OutputSegments&& _output)
+{
+    size_t length = 0;
+    for (auto const& segment: _input)
+        length += detail::scatter::input_segment(segment).second;
+
+    auto writer = detail::scatter::writer(std::begin(_output), std::end(_output));
+    auto const kernel = [](uint8_t const* _in, size_t _size, uint8_t* _out, size_t) {
+        encode(_in, _size, _out);
+    };
+
+    uint8_t carry[12];
+    auto const offset = detail::scatter::transform<12, 16>(_input, length, writer, kernel, carry);
+
+    uint8_t tail[16];
+    auto const tailLength = detail::encoder::simple::encode(carry, carry + (length - offset), tail);
+    writer.write(tail, tailLength);
+
+    return writer.written();
+}
+
+} // namespace base64
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/decode.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+#if __has_include(<span>) && __cplusplus > 201703L
+    #include <span>
+#endif
+
+namespace base64
+{
+
+/// Default chunk size of decode_to_sink(), small enough to stay in L1 cache.
+constexpr inline size_t default_sink_chunk_size = 16 * 1024;
+
+namespace detail
+{
+    template <typename Sink>
+    void emit(Sink& _sink, uint8_t const* _data, size_t _size)
+    {
+#if defined(__cpp_lib_span)
+        if constexpr (std::is_invocable_v<Sink&, std::span<uint8_t const>>)
+            _sink(std::span<uint8_t const>(_data, _size));
+        else
+#endif
+            _sink(_data, _size);
+    }
+}
+
+/// Decodes @p _input, with optional trailing '=' padding, chunk by chunk into
+/// one reused buffer and pushes every decoded chunk to @p _sink before
+/// decoding the next one, so that the consumer reads cache-hot data.
+///
+/// @p _sink is invoked with a std::span<uint8_t const> if it accepts one
+/// (C++20), otherwise with (uint8_t const* data, size_t size).
+/// The chunk is only valid for the duration of the call.
+///
+/// @p _chunkSize is the maximum number of bytes per chunk, rounded down to a
+/// multiple of 12 (at least 12). Only the last chunk may be smaller.
+///
+/// Throws invalid_input with the offset into @p _input; chunks before the
+/// invalid block have already been pushed to the sink by then.
+///
+/// @returns the total number of decoded bytes.
+template <typename Sink>
+size_t decode_to_sink(std::string_view _input, Sink&& _sink, size_t _chunkSize = default_sink_chunk_size)
+{
+    while (!_input.empty() && _input.back() == '=')
+        _input.remove_suffix(1);
+
+    if (_input.empty())
+        return 0;
+
+    // Every chunk but the last one is decoded by the block kernel,
+    // whose input must be a multiple of 16 characters (12 bytes).
+    auto const chunkOutputSize = _chunkSize < 12 ? size_t(12) : _chunkSize - _chunkSize % 12;
+    auto const chunkInputSize = (chunkOutputSize / 3) * 4;
+
+    // every byte is decoded into before it is emitted, so it is not value-initialized
+    auto const buffer = std::unique_ptr<uint8_t[]>(new uint8_t[chunkOutputSize]);
+    auto const decodeChunk = [&](size_t _offset) -> size_t {
+        try
+        {
+            if (_offset + chunkInputSize < _input.size())
+            {
+                decode(reinterpret_cast<uint8_t const*>(_input.data() + _offset), chunkInputSize, buffer.get());
+                return chunkOutputSize;
+            }
+            return decode(_input.substr(_offset), buffer.get());
+        }
+        catch (detail::decoder::invalid_input const& e)
+        {
+            throw detail::decoder::invalid_input{_offset + e.offset, e.byte};
+        }
+    };
+
+    size_t total = 0;
+    for (size_t offset = 0; offset < _input.size(); offset += chunkInputSize)
+    {
+        auto const size = decodeChunk(offset);
+        detail::emit(_sink, buffer.get(), size);
+        total += size;
+    }
+
+    return total;
+}
+
+} // namespace base64
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/detail/dispatch.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <string_view>
+
+namespace base64::detail::decoder
+{
+
+/// Prefix decoding kernel, see sse::decode_valid_prefix().
+using prefix_kernel_fn = size_t (*)(uint8_t const* _input, size_t _size, uint8_t* _output);
+
+/// All prefix decoding kernels, ordered from best to worst.
+inline constexpr std::array prefix_kernels {
+#if defined(BASE64_CPP_X86)
+    dispatch::kernel<prefix_kernel_fn>{"sse", cpu::to_set(cpu::feature::SSSE3), &sse::decode_valid_prefix},
+#endif
+    dispatch::kernel<prefix_kernel_fn>{"simple", 0, &simple::decode_valid_prefix},
+};
+
+inline prefix_kernel_fn& selected_prefix_kernel() noexcept
+{
+    static prefix_kernel_fn kernel = dispatch::select(prefix_kernels);
+    return kernel;
+}
+
+}
+
+namespace base64
+{
+
+/// Set of bytes that terminate an embedded base64 payload,
+/// such as BEL and ESC for payloads within OSC, DCS or APC sequences.
+///
+/// Terminators must be neither alphabet characters nor '=': those are taken
+/// as payload (or padding), so they could never stop decode_until(). Inserting
+/// one asserts, which fails to compile for a set built in a constant expression.
+class terminator_set
+{
+  public:
+    constexpr terminator_set() noexcept = default;
+
+    constexpr explicit terminator_set(std::string_view _bytes) noexcept
+    {
+        for (auto const c: _bytes)
+            insert(static_cast<uint8_t>(c));
+    }
+
+    constexpr void insert(uint8_t _byte) noexcept
+    {
+        assert(!is_payload(_byte) && "terminators must not be base64 characters or '='");
+        bits_[_byte / 64] |= uint64_t(1) << (_byte % 64);
+    }
+
+    constexpr bool contains(uint8_t _byte) const noexcept
+    {
+        return (bits_[_byte / 64] >> (_byte % 64)) & 1;
+    }
+
+  private:
+    static constexpr bool is_payload(uint8_t _byte) noexcept
+    {
+        return (_byte >= 'A' && _byte <= 'Z') || (_byte >= 'a' && _byte <= 'z') || (_byte >= '0' && _byte <= '9')
+               || _byte == '+' || _byte == '/' || _byte == '=';
+    }
+
+    std::array<uint64_t, 4> bits_ {};
+};
+
+/// Reason for decode_until() to stop.
+enum class stop_reason
+{
+    end_of_input, //!< the whole input has been decoded
+    terminator,   //!< a byte of the terminator set has been reached
+    invalid,      //!< a byte that is neither base64 nor a terminator has been reached
+};
+
+struct decode_until_result
+{
+    size_t bytes_written;  //!< number of decoded bytes
+    size_t chars_consumed; //!< number of characters before the stop, including padding
+    stop_reason reason;
+};
+
+/// Decodes the base64 payload at the beginning of @p _input up to the first
+/// byte of @p _terminators, in a single pass.
+///
+/// The SIMD kernel decodes whole blocks until its invalid character mask
+/// reports a non-alphabet character, which locates the end of the payload
+/// without a separate search. The payload may end with '=' padding, which is
+/// consumed. Like decode(), an incomplete final group is decoded leniently.
+///
+/// When stopped by a terminator or an invalid byte, chars_consumed is the
+/// offset of that byte in @p _input.
+///
+/// @p _output must provide room for at least (3 * _input.size()) / 4 bytes.
+inline decode_until_result decode_until(std::string_view _input, terminator_set const& _terminators, uint8_t* _output)
+{
+    auto const input = reinterpret_cast<uint8_t const*>(_input.data());
+    auto const mainInputLength = _input.size() & ~size_t(15);
+
+    auto stop = detail::decoder::selected_prefix_kernel()(input, mainInputLength, _output);
+
+    // Everything before the block of the stop has been decoded. The remaining
+    // payload characters (at most 15) are handled by the scalar decoder.
+    auto const blockStart = stop & ~size_t(15);
+    if (stop == mainInputLength)
+        while (stop < _input.size() && detail::decoder::simple::alphabetIndexMap[input[stop]] <= 63)
+            ++stop;
+
+    auto const bytesWritten = (blockStart / 4) * 3 + detail::decoder::simple::decode(input + blockStart,
+                                                                                  input + stop,
+                                                                                  _output + (blockStart / 4) * 3);
+
+    while (stop < _input.size() && input[stop] == '=')
+        ++stop;
+
+    if (stop == _input.size())
+        return {bytesWritten, stop, stop_reason::end_of_input};
+    if (_terminators.contains(input[stop]))
+        return {bytesWritten, stop, stop_reason::terminator};
+    return {bytesWritten, stop, stop_reason::invalid};
+}
+
+} // namespace base64
@@ -0,0 +1,247 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/encode.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<range/v3/range/concepts.hpp>)
+#include <range/v3/range/concepts.hpp>
+#endif
+
+// Lazy range adaptors that decode (or encode) one SIMD block at a time.
+//
+//     for (uint8_t const byte: payload | base64::views::decode)
+//         parser.feed(byte);
+//
+// Only the bytes that are actually iterated over get decoded, so peeking
+// at the first few bytes (e.g. file magic) of a large payload is cheap.
+//
+// The views work with any input range of byte-like values and
+// model range-v3's view concept when range-v3 is available.
+
+namespace base64::detail::views
+{
+
+#if __has_include(<range/v3/range/concepts.hpp>)
+using view_base = ::ranges::view_base;
+#else
+struct view_base {};
+#endif
+
+// {{{ range_holder
+template <typename Range>
+struct range_holder // owns rvalue ranges
+{
+    range_holder() = default;
+    explicit range_holder(Range&& _range): range{std::move(_range)} {}
+
+    Range const& get() const noexcept { return range; }
+
+    Range range;
+};
+
+template <typename Range>
+struct range_holder<Range&> // refers to lvalue ranges
+{
+    range_holder() = default;
+    explicit range_holder(Range& _range): range{&_range} {}
+
+    Range& get() const noexcept { return *range; }
+
+    Range* range = nullptr;
+};
+// }}}
+
+// {{{ codecs
+struct decode_block
+{
+    static constexpr size_t input_size = 16;
+    static constexpr size_t output_size = 16; // 12 bytes used, the rest is store slack.
+
+    using value_type = uint8_t;
+
+    static size_t process(uint8_t const* _input, size_t _size, bool _final, value_type* _output, size_t _offset)
+    {
+        if (_final)
+            while (_size && _input[_size - 1] == '=')
+                --_size;
+
+        if (_size != input_size)
+            return decoder::simple::decode(_input, _input + _size, _output);
+
+        try
+        {
+            base64::decode(_input, input_size, _output);
+        }
+        catch (decoder::invalid_input const& e)
+        {
+            throw decoder::invalid_input{_offset + e.offset, e.byte};
+        }
+        return 12;
+    }
+};
+
+struct encode_block
+{
+    static constexpr size_t input_size = 12;
+    static constexpr size_t output_size = 16;
+
+    using value_type = char;
+
+    static size_t process(uint8_t const* _input, size_t _size, bool /*_final*/, value_type* _output, size_t /*_offset*/)
+    {
+        if (_size != input_size)
+            return encoder::simple::encode(_input, _input + _size, _output);
+
+        base64::encode(_input, input_size, reinterpret_cast<uint8_t*>(_output));
+        return output_size;
+    }
+};
+// }}}
+
+// {{{ block_iterator
+/// Single-pass iterator that pulls one block of the underlying range at a time
+/// and hands out the transcoded bytes from its internal buffer.
+template <typename Codec, typename I, typename S>
+class block_iterator
+{
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using iterator_concept = std::input_iterator_tag;
+    using value_type = typename Codec::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type const*;
+    using reference = value_type const&;
+
+    block_iterator() = default;
+
+    block_iterator(I _first, S _last): current_{std::move(_first)}, end_{std::move(_last)}, done_{false}
+    {
+        refill();
+    }
+
+    reference operator*() const noexcept { return buffer_[pos_]; }
+    pointer operator->() const noexcept { return &buffer_[pos_]; }
+
+    block_iterator& operator++()
+    {
+        if (++pos_ == length_)
+            refill();
+        return *this;
+    }
+
+    block_iterator operator++(int)
+    {
+        auto old = *this;
+        ++*this;
+        return old;
+    }
+
+    friend bool operator==(block_iterator const& a, block_iterator const& b) noexcept
+    {
+        if (a.done_ || b.done_)
+            return a.done_ == b.done_;
+        return a.offset_ == b.offset_ && a.pos_ == b.pos_;
+    }
+
+    friend bool operator!=(block_iterator const& a, block_iterator const& b) noexcept
+    {
+        return !(a == b);
+    }
+
+  private:
+    void refill()
+    {
+        pos_ = 0;
+        length_ = 0;
+
+        // The final block may transcode into nothing (e.g. "=="), hence the loop.
+        while (length_ == 0)
+        {
+            if (current_ == end_)
+            {
+                done_ = true;
+                return;
+            }
+
+            std::array<uint8_t, Codec::input_size> input;
+            size_t count = 0;
+            while (count < input.size() && current_ != end_)
+                input[count++] = static_cast<uint8_t>(*current_++);
+
+            length_ = Codec::process(input.data(), count, current_ == end_, buffer_.data(), offset_);
+            offset_ += count;
+        }
+    }
+
+    I current_ {};
+    S end_ {};
+    std::array<value_type, Codec::output_size> buffer_ {};
+    size_t pos_ = 0;
+    size_t length_ = 0;
+    size_t offset_ = 0; // number of input elements consumed so far
+    bool done_ = true;
+};
+// }}}
+
+// {{{ block_view
+template <typename Codec, typename Range>
+class block_view: public view_base
+{
+  private:
+    using base_range = decltype(std::declval<range_holder<Range> const&>().get());
+    using base_iterator = decltype(std::begin(std::declval<base_range>()));
+    using base_sentinel = decltype(std::end(std::declval<base_range>()));
+
+  public:
+    using iterator = block_iterator<Codec, base_iterator, base_sentinel>;
+
+    block_view() = default;
+    explicit block_view(range_holder<Range> _range): range_{std::move(_range)} {}
+
+    iterator begin() const { return iterator{std::begin(range_.get()), std::end(range_.get())}; }
+    iterator end() const noexcept { return iterator{}; }
+
+  private:
+    range_holder<Range> range_;
+};
+
+template <typename Codec>
+struct block_view_fn
+{
+    template <typename Range>
+    auto operator()(Range&& _range) const
+    {
+        return block_view<Codec, Range>{range_holder<Range>{std::forward<Range>(_range)}};
+    }
+
+    template <typename Range>
+    friend auto operator|(Range&& _range, block_view_fn _fn)
+    {
+        return _fn(std::forward<Range>(_range));
+    }
+};
+// }}}
+
+}
+
+namespace base64::views
+{
+
+/// Lazily decodes a range of base64 characters into a range of bytes.
+///
+/// Throws detail::decoder::invalid_input (with the offset into the input range)
+/// once iteration reaches a block that contains a non-alphabet character.
+inline constexpr detail::views::block_view_fn<detail::views::decode_block> decode {};
+
+/// Lazily encodes a range of bytes into a range of (padded) base64 characters.
+inline constexpr detail::views::block_view_fn<detail::views::encode_block> encode {};
+
+}
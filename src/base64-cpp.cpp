@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// The compiled library (CMake target base64-cpp::compiled).
+//
+// Every kernel is compiled exactly once, here, with its own per-function
+// target attributes, while this translation unit itself stays at the
+// baseline of the build.
+//
+// On ELF platforms the entry points are GNU ifuncs: the dynamic loader runs
+// the resolvers once at load time and binds each symbol directly to the
+// selected kernel, so there is neither first-call detection nor an extra
+// indirection on the hot path. Elsewhere they forward to the lazily
+// selected kernel of the header-only dispatcher.
+
+#include <base64-cpp/base16.hpp>
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/encode.hpp>
+
+#if !defined(BASE64_CPP_COMPILED)
+    #error "BASE64_CPP_COMPILED must be defined when building the compiled library"
+#endif
+
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__)) && !defined(BASE64_CPP_NO_IFUNC)
+    #define BASE64_CPP_HAVE_IFUNC 1
+#endif
+
+namespace dispatch = base64::detail::dispatch;
+
+#if defined(BASE64_CPP_HAVE_IFUNC)
+
+// Resolvers run before the program's constructors, so they must only use
+// code without static state: cpu::available_features() queries cpuid
+// directly and the kernel tables are constant.
+extern "C"
+{
+    static base64::detail::decoder::kernel_fn base64_cpp_resolve_decode()
+    {
+        return dispatch::select(base64::detail::decoder::kernels);
+    }
+
+    static base64::detail::decoder::kernel_fn base64_cpp_resolve_decode_trusted()
+    {
+        return dispatch::select(base64::detail::decoder::trusted_kernels);
+    }
+
+    static base64::detail::decoder::tail_kernel_fn base64_cpp_resolve_decode_tail()
+    {
+        return dispatch::select(base64::detail::decoder::tail_kernels);
+    }
+
+    static base64::detail::encoder::kernel_fn base64_cpp_resolve_encode()
+    {
+        return dispatch::select(base64::detail::encoder::kernels);
+    }
+
+    static base16::detail::kernel_fn base64_cpp_resolve_base16_decode()
+    {
+        return dispatch::select(base16::detail::decode_kernels);
+    }
+
+    static base16::detail::kernel_fn base64_cpp_resolve_base16_encode()
+    {
+        return dispatch::select(base16::detail::encode_kernels);
+    }
+
+    void base64_cpp_decode(uint8_t const*, size_t, uint8_t*) __attribute__((ifunc("base64_cpp_resolve_decode")));
+    void base64_cpp_decode_trusted(uint8_t const*, size_t, uint8_t*) __attribute__((ifunc("base64_cpp_resolve_decode_trusted")));
+    size_t base64_cpp_decode_tail(uint8_t const*, size_t, uint8_t*) __attribute__((ifunc("base64_cpp_resolve_decode_tail")));
+    void base64_cpp_encode(uint8_t const*, size_t, uint8_t*) __attribute__((ifunc("base64_cpp_resolve_encode")));
+    void base64_cpp_base16_decode(uint8_t const*, size_t, uint8_t*) __attribute__((ifunc("base64_cpp_resolve_base16_decode")));
+    void base64_cpp_base16_encode(uint8_t const*, size_t, uint8_t*) __attribute__((ifunc("base64_cpp_resolve_base16_encode")));
+}
+
+#else
+
+extern "C"
+{
+    void base64_cpp_decode(uint8_t const* _input, size_t _size, uint8_t* _output)
+    {
+        base64::detail::decoder::selected_kernel()(_input, _size, _output);
+    }
+
+    void base64_cpp_decode_trusted(uint8_t const* _input, size_t _size, uint8_t* _output)
+    {
+        base64::detail::decoder::selected_trusted_kernel()(_input, _size, _output);
+    }
+
+    size_t base64_cpp_decode_tail(uint8_t const* _input, size_t _size, uint8_t* _output)
+    {
+        return base64::detail::decoder::selected_tail_kernel()(_input, _size, _output);
+    }
+
+    void base64_cpp_encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+    {
+        base64::detail::encoder::selected_kernel()(_input, _size, _output);
+    }
+
+    void base64_cpp_base16_decode(uint8_t const* _input, size_t _size, uint8_t* _output)
+    {
+        base16::detail::selected_decode_kernel()(_input, _size, _output);
+    }
+
+    void base64_cpp_base16_encode(uint8_t const* _input, size_t _size, uint8_t* _output)
+    {
+        base16::detail::selected_encode_kernel()(_input, _size, _output);
+    }
+}
+
+#endif
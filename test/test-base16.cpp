@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <base64-cpp/base16.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <string>
+#include <string_view>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+    std::string sample(size_t _size)
+    {
+        std::string data;
+        for (size_t i = 0; i < _size; ++i)
+            data.push_back(static_cast<char>(i * 37 + 11));
+        return data;
+    }
+}
+
+TEST_CASE("base16.encode")
+{
+    CHECK(base16::encode(""sv) == "");
+    CHECK(base16::encode("\x01\xab\xff"sv) == "01abff");
+    CHECK(base16::encode("0123456789abcdef:0123456789abcdef"sv)
+          == "303132333435363738396162636465663a30313233343536373839616263646566");
+}
+
+TEST_CASE("base16.decode")
+{
+    CHECK(base16::decode(""sv) == "");
+    CHECK(base16::decode("01abff"sv) == "\x01\xab\xff"s);
+    CHECK(base16::decode("01ABFF"sv) == "\x01\xab\xff"s);
+    CHECK(base16::decode("303132333435363738396162636465663A30313233343536373839616263646566"sv)
+          == "0123456789abcdef:0123456789abcdef");
+}
+
+TEST_CASE("base16.decode.invalid")
+{
+    auto const check = [](std::string_view _input, size_t _offset) {
+        try
+        {
+            base16::decode(_input);
+            FAIL("invalid_input expected");
+        }
+        catch (base16::invalid_input const& e)
+        {
+            CHECK(e.offset == _offset);
+            CHECK(e.byte == static_cast<uint8_t>(_input[_offset]));
+        }
+    };
+
+    check("0g"sv, 1);
+    check("abc"sv, 2);
+    auto input = base16::encode(sample(100));
+    for (auto const offset: {0u, 17u, 31u, 32u, 63u, 64u, 150u, 199u})
+    {
+        auto const saved = input[offset];
+        input[offset] = offset % 2 ? 'G' : '/';
+        check(input, offset);
+        input[offset] = saved;
+    }
+}
+
+TEST_CASE("base16.kernels")
+{
+    auto const available = base64::detail::cpu::available_features();
+    for (size_t size: {0u, 1u, 15u, 16u, 31u, 32u, 33u, 64u, 100u, 1000u})
+    {
+        auto const data = sample(size);
+        auto const bytes = reinterpret_cast<uint8_t const*>(data.data());
+        auto const expected = base16::encode(data);
+
+        for (auto const& kernel: base16::detail::encode_kernels)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << size);
+            std::string encoded(2 * size, '\0');
+            kernel.function(bytes, size, reinterpret_cast<uint8_t*>(encoded.data()));
+            CHECK(encoded == expected);
+        }
+
+        for (auto const& kernel: base16::detail::decode_kernels)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << size);
+            std::string decoded(size, '\0');
+            kernel.function(reinterpret_cast<uint8_t const*>(expected.data()),
+                            expected.size(),
+                            reinterpret_cast<uint8_t*>(decoded.data()));
+            CHECK(decoded == data);
+        }
+    }
+}
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <base64-cpp/base32.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+    std::string sample(size_t _size)
+    {
+        std::string data;
+        for (size_t i = 0; i < _size; ++i)
+            data.push_back(static_cast<char>(i * 37 + 11));
+        return data;
+    }
+}
+
+TEST_CASE("base32.rfc4648")
+{
+    using base32::alphabet;
+
+    CHECK(base32::encode(""sv) == "");
+    CHECK(base32::encode("f"sv) == "MY======");
+    CHECK(base32::encode("fo"sv) == "MZXQ====");
+    CHECK(base32::encode("foo"sv) == "MZXW6===");
+    CHECK(base32::encode("foob"sv) == "MZXW6YQ=");
+    CHECK(base32::encode("fooba"sv) == "MZXW6YTB");
+    CHECK(base32::encode("foobar"sv) == "MZXW6YTBOI======");
+
+    CHECK(base32::encode("f"sv, alphabet::extended_hex) == "CO======");
+    CHECK(base32::encode("fo"sv, alphabet::extended_hex) == "CPNG====");
+    CHECK(base32::encode("foo"sv, alphabet::extended_hex) == "CPNMU===");
+    CHECK(base32::encode("foob"sv, alphabet::extended_hex) == "CPNMUOG=");
+    CHECK(base32::encode("fooba"sv, alphabet::extended_hex) == "CPNMUOJ1");
+    CHECK(base32::encode("foobar"sv, alphabet::extended_hex) == "CPNMUOJ1E8======");
+
+    CHECK(base32::decode(""sv) == "");
+    CHECK(base32::decode("MY======"sv) == "f");
+    CHECK(base32::decode("MZXQ===="sv) == "fo");
+    CHECK(base32::decode("MZXW6==="sv) == "foo");
+    CHECK(base32::decode("MZXW6YQ="sv) == "foob");
+    CHECK(base32::decode("MZXW6YTB"sv) == "fooba");
+    CHECK(base32::decode("mzxw6ytboi======"sv) == "foobar");
+
+    CHECK(base32::decode("CO======"sv, alphabet::extended_hex) == "f");
+    CHECK(base32::decode("CPNMUOG="sv, alphabet::extended_hex) == "foob");
+    CHECK(base32::decode("cpnmuoj1e8======"sv, alphabet::extended_hex) == "foobar");
+}
+
+TEST_CASE("base32.roundtrip")
+{
+    for (auto const a: {base32::alphabet::standard, base32::alphabet::extended_hex})
+    {
+        for (size_t size = 0; size < 100; ++size)
+        {
+            INFO(size);
+            auto const data = sample(size);
+            auto const encoded = base32::encode(data, a);
+            CHECK(encoded.size() == base32::encoded_size(size));
+            CHECK(base32::decode(encoded, a) == data);
+        }
+    }
+}
+
+TEST_CASE("base32.decode.invalid")
+{
+    auto const check = [](std::string_view _input, size_t _offset) {
+        try
+        {
+            base32::decode(_input);
+            FAIL("invalid_input expected");
+        }
+        catch (base32::invalid_input const& e)
+        {
+            CHECK(e.offset == _offset);
+        }
+    };
+
+    check("MZXW6YT1"sv, 7);
+    check("MZXW6YTBO"sv, 8); // impossible final group length
+    auto input = base32::encode(sample(40));
+    for (auto const offset: {0u, 15u, 16u, 40u, 63u})
+    {
+        auto const saved = input[offset];
+        input[offset] = '8';
+        check(input, offset);
+        input[offset] = saved;
+    }
+}
+
+TEST_CASE("base32.kernels")
+{
+    using base32::alphabet;
+
+    auto const available = base64::detail::cpu::available_features();
+    for (size_t size: {0u, 5u, 10u, 15u, 20u, 100u, 1000u})
+    {
+        auto const data = sample(size);
+        auto const bytes = reinterpret_cast<uint8_t const*>(data.data());
+        std::string expected(size / 5 * 8, '\0');
+        base32::detail::simple::encode<alphabet::standard>(bytes, size, reinterpret_cast<uint8_t*>(expected.data()));
+
+        for (auto const& kernel: base32::detail::encode_kernels<alphabet::standard>)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << size);
+            std::string encoded(expected.size(), '\0');
+            kernel.function(bytes, size, reinterpret_cast<uint8_t*>(encoded.data()));
+            CHECK(encoded == expected);
+        }
+
+        for (auto const& kernel: base32::detail::decode_kernels<alphabet::standard>)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << size);
+            std::string decoded(size, '\0');
+            kernel.function(reinterpret_cast<uint8_t const*>(expected.data()),
+                            expected.size(),
+                            reinterpret_cast<uint8_t*>(decoded.data()));
+            CHECK(decoded == data);
+        }
+    }
+}
+
+TEST_CASE("base32.kernels.exact_output")
+{
+    using base32::alphabet;
+
+    // heap buffers of exactly the decoded size, so that ASan catches stores past them
+    auto const available = base64::detail::cpu::available_features();
+    for (size_t chars: {24u, 40u, 56u})
+    {
+        auto const data = sample(chars / 8 * 5);
+        auto const encoded = base32::encode(data);
+        REQUIRE(encoded.size() == chars);
+
+        for (auto const& kernel: base32::detail::decode_kernels<alphabet::standard>)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << chars);
+            auto const decoded = std::make_unique<uint8_t[]>(data.size());
+            kernel.function(reinterpret_cast<uint8_t const*>(encoded.data()), encoded.size(), decoded.get());
+            CHECK(std::string(reinterpret_cast<char const*>(decoded.get()), data.size()) == data);
+        }
+    }
+}
@@ -1,9 +1,31 @@
 // SPDX-License-Identifier: Apache-2.0
+#include <base64-cpp/autotune.hpp>
+#include <base64-cpp/checksum.hpp>
 #include <base64-cpp/decode.hpp>
+#include <base64-cpp/encode.hpp>
+#include <base64-cpp/fixed.hpp>
+#include <base64-cpp/iterator.hpp>
+#include <base64-cpp/job.hpp>
+#include <base64-cpp/json.hpp>
+#include <base64-cpp/pixels.hpp>
+#include <base64-cpp/scatter.hpp>
+#include <base64-cpp/sink.hpp>
+#include <base64-cpp/terminator.hpp>
 #include <catch2/catch_all.hpp>
 
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -69,3 +91,870 @@ TEST_CASE("accelerated-2-remainder-3")
     auto const output   = base64::decode(input);
     CHECK(output == expected);
 }
+
+TEST_CASE("decode-into-buffer")
+{
+    auto const input = "MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBRYWI="sv;
+    uint8_t output[27] = {};
+    auto const n = base64::decode(input, output);
+    REQUIRE(n == 26);
+    CHECK(std::string_view(reinterpret_cast<char const*>(output), n) == "123456789012ABCDEF1234PQab");
+}
+
+TEST_CASE("decode-pixels.rgb24")
+{
+    // 7 RGB pixels: 4 via the SIMD kernel, 3 via the scalar tail.
+    std::string rgb;
+    for (int i = 0; i < 7 * 3; ++i)
+        rgb.push_back(static_cast<char>(i + 1));
+    auto const input = base64::encode(rgb);
+
+    std::vector<uint8_t> rgba(input.size());
+    auto const pixelCount = base64::decode_pixels(input, base64::pixel_format::rgb24, rgba.data(), 0x80);
+    REQUIRE(pixelCount == 7);
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        CHECK(rgba[4 * i + 0] == rgb[3 * i + 0]);
+        CHECK(rgba[4 * i + 1] == rgb[3 * i + 1]);
+        CHECK(rgba[4 * i + 2] == rgb[3 * i + 2]);
+        CHECK(rgba[4 * i + 3] == 0x80);
+    }
+}
+
+TEST_CASE("decode-pixels.rgba32")
+{
+    auto const rgba = "\x01\x02\x03\xff\x04\x05\x06\x7f\x07\x08\x09\x00\x0a\x0b\x0c\x10"s;
+    auto const input = base64::encode(rgba);
+
+    std::vector<uint8_t> output(input.size());
+    CHECK(base64::decode_pixels(input, base64::pixel_format::rgba32, output.data()) == 4);
+    CHECK(std::string(output.begin(), output.begin() + 16) == rgba);
+}
+
+TEST_CASE("decode-with-crc32c")
+{
+    std::vector<uint8_t> output(16);
+    auto const result = base64::decode_with_crc32c(base64::encode("123456789"), output.data());
+    CHECK(result.size == 9);
+    CHECK(result.checksum == 0xe3069283);
+}
+
+TEST_CASE("decode-with-adler32")
+{
+    std::vector<uint8_t> output(16);
+    auto const result = base64::decode_with_adler32(base64::encode("Wikipedia"), output.data());
+    CHECK(result.size == 9);
+    CHECK(result.checksum == 0x11e60398);
+}
+
+TEST_CASE("decode-with-checksum.large")
+{
+    // Large enough to span multiple Adler-32 reduction chunks.
+    std::string data;
+    for (int i = 0; i < 20000; ++i)
+        data.push_back(static_cast<char>(0xff - (i % 7)));
+    auto const input = base64::encode(data);
+    auto const bytes = reinterpret_cast<uint8_t const*>(data.data());
+
+    std::vector<uint8_t> output(input.size());
+
+    auto const crc = base64::decode_with_crc32c(input, output.data());
+    CHECK(crc.size == data.size());
+    CHECK(crc.checksum == ~base64::detail::checksum::simple::crc32c_update(~0u, bytes, data.size()));
+    CHECK(std::string(output.begin(), output.begin() + data.size()) == data);
+
+    auto const adler = base64::decode_with_adler32(input, output.data());
+    CHECK(adler.size == data.size());
+    CHECK(adler.checksum == base64::detail::checksum::simple::adler32_update(1, bytes, data.size()));
+}
+
+TEST_CASE("decode.kernels")
+{
+    auto const available = base64::detail::cpu::available_features();
+
+    std::string data;
+    for (int i = 0; i < 300; ++i)
+        data.push_back(static_cast<char>(i * 37 + 11));
+
+    for (size_t size: {0u, 12u, 24u, 36u, 48u, 96u, 108u, 300u})
+    {
+        auto const input = base64::encode(std::string_view(data).substr(0, size));
+        auto const bytes = reinterpret_cast<uint8_t const*>(input.data());
+
+        for (auto const& kernel: base64::detail::decoder::kernels)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << size);
+
+            // one byte of headroom to detect writes past the decoded bytes
+            std::string output(size + 1, '#');
+            kernel.function(bytes, input.size(), reinterpret_cast<uint8_t*>(output.data()));
+            CHECK(output.substr(0, size) == data.substr(0, size));
+            CHECK(output.back() == '#');
+
+            if (size)
+            {
+                auto invalid = input;
+                invalid[input.size() - 5] = '*';
+                try
+                {
+                    kernel.function(reinterpret_cast<uint8_t const*>(invalid.data()),
+                                    invalid.size(),
+                                    reinterpret_cast<uint8_t*>(output.data()));
+                    FAIL("invalid_input expected");
+                }
+                catch (base64::detail::decoder::invalid_input const& e)
+                {
+                    CHECK(e.offset == input.size() - 5);
+                }
+            }
+        }
+
+        for (auto const& kernel: base64::detail::crc32c_kernels)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << size);
+            std::string output(size, '\0');
+            auto const crc = kernel.function(bytes, input.size(), reinterpret_cast<uint8_t*>(output.data()), ~0u);
+            CHECK(output == data.substr(0, size));
+            CHECK(crc == base64::detail::checksum::simple::crc32c_update(
+                             ~0u, reinterpret_cast<uint8_t const*>(data.data()), size));
+        }
+
+        for (auto const& kernel: base64::detail::adler32_kernels)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << size);
+            std::string output(size, '\0');
+            auto const adler = kernel.function(bytes, input.size(), reinterpret_cast<uint8_t*>(output.data()), 1);
+            CHECK(output == data.substr(0, size));
+            CHECK(adler == base64::detail::checksum::simple::adler32_update(
+                               1, reinterpret_cast<uint8_t const*>(data.data()), size));
+        }
+
+        for (auto const& kernel: base64::detail::decoder::rgba_kernels)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << size);
+            std::vector<uint8_t> rgba(size / 3 * 4);
+            kernel.function(bytes, input.size(), rgba.data(), 0x42);
+            for (size_t i = 0; i < size / 3; ++i)
+            {
+                CHECK(rgba[4 * i + 0] == uint8_t(data[3 * i + 0]));
+                CHECK(rgba[4 * i + 3] == 0x42);
+            }
+        }
+    }
+}
+
+TEST_CASE("decode-to-sink")
+{
+    std::string data;
+    for (int i = 0; i < 1000; ++i)
+        data.push_back(static_cast<char>(i * 13 + 5));
+
+    for (size_t size: {0u, 1u, 12u, 100u, 120u, 1000u})
+    {
+        auto const input = base64::encode(std::string_view(data).substr(0, size));
+        for (size_t chunkSize: {size_t(1), size_t(12), size_t(50), size_t(120), base64::default_sink_chunk_size})
+        {
+            INFO(size << " " << chunkSize);
+            auto const effectiveChunkSize = chunkSize < 12 ? 12 : chunkSize - chunkSize % 12;
+            std::string output;
+            size_t chunks = 0;
+            uint8_t const* previous = nullptr;
+            auto const total = base64::decode_to_sink(input, [&](uint8_t const* _data, size_t _size) {
+                CHECK(_size <= effectiveChunkSize);
+                CHECK((previous == nullptr || previous == _data)); // one reused buffer
+                previous = _data;
+                output.append(reinterpret_cast<char const*>(_data), _size);
+                ++chunks;
+            }, chunkSize);
+            CHECK(total == size);
+            CHECK(output == data.substr(0, size));
+            CHECK(chunks == (size + effectiveChunkSize - 1) / effectiveChunkSize);
+        }
+    }
+
+    auto input = base64::encode(data);
+    input[700] = '*';
+    size_t received = 0;
+    try
+    {
+        base64::decode_to_sink(input, [&](uint8_t const*, size_t _size) { received += _size; }, 120);
+        FAIL("invalid_input expected");
+    }
+    catch (base64::detail::decoder::invalid_input const& e)
+    {
+        CHECK(e.offset == 700);
+        CHECK(received == 480); // the chunks before the invalid one
+    }
+}
+
+TEST_CASE("decode.job")
+{
+    std::string data;
+    for (int i = 0; i < 1000; ++i)
+        data.push_back(static_cast<char>(i * 13 + 5));
+
+    for (size_t size: {0u, 1u, 12u, 13u, 100u, 120u, 1000u})
+    {
+        auto const input = base64::encode(std::string_view(data).substr(0, size));
+        for (size_t budget: {size_t(0), size_t(12), size_t(50), size_t(120), base64::decode_job_slice_size})
+        {
+            INFO(size << " " << budget);
+            std::vector<uint8_t> output(size);
+            base64::decode_job job(input, output.data());
+            size_t steps = 0;
+            size_t previous = 0;
+            while (!job.step(budget))
+            {
+                CHECK(job.bytes_written() - previous <= std::max(budget, size_t(12)));
+                CHECK(job.bytes_written() % 12 == 0);
+                previous = job.bytes_written();
+                ++steps;
+            }
+            CHECK(job.done());
+            CHECK(!job.error());
+            CHECK(job.position() == input.size());
+            CHECK(job.bytes_written() == size);
+            CHECK(std::string(output.begin(), output.end()) == data.substr(0, size));
+            CHECK(steps <= size / std::max(budget, size_t(12)));
+            CHECK(job.step(budget)); // stays done
+        }
+    }
+
+    auto const input = base64::encode(data);
+    std::vector<uint8_t> output(data.size());
+    base64::decode_job job(input, output.data());
+    CHECK(job.step(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+    CHECK(std::string(output.begin(), output.end()) == data);
+
+    // a deadline in the past still makes progress: exactly one slice per step
+    std::string large;
+    for (size_t i = 0; i < 2 * base64::decode_job_slice_size + 1000; ++i)
+        large.push_back(static_cast<char>(i * 31 + 7));
+    auto const largeInput = base64::encode(large);
+    std::vector<uint8_t> largeOutput(large.size());
+    base64::decode_job<base64::decode_mode::trusted> trusted(largeInput, largeOutput.data());
+    auto const past = std::chrono::steady_clock::time_point {};
+    CHECK(!trusted.step(past));
+    CHECK(trusted.bytes_written() == base64::decode_job_slice_size);
+    size_t pastSteps = 1;
+    while (!trusted.step(past))
+        ++pastSteps;
+    ++pastSteps;
+    CHECK(pastSteps == 3);
+    CHECK(!trusted.error());
+    CHECK(trusted.bytes_written() == large.size());
+    CHECK(std::string(largeOutput.begin(), largeOutput.end()) == base64::decode(std::string_view(largeInput)));
+
+    // errors stop the job at the same offset as decode() throws
+    for (size_t const at: {size_t(5), size_t(700), input.size() - 12})
+    {
+        auto invalid = input;
+        invalid[at] = '*';
+        base64::decode_job failing(invalid, output.data());
+        while (!failing.step(size_t(120)))
+            ;
+        REQUIRE(failing.error());
+        CHECK(failing.error()->offset == at);
+        CHECK(failing.error()->byte == '*');
+        CHECK(failing.bytes_written() == (at / 160) * 120); // the steps before the invalid block
+    }
+
+    // strict mode checks the padding of the final block
+    auto const unpadded = input.substr(0, input.size() - 1);
+    base64::decode_job<base64::decode_mode::strict> strict(unpadded, output.data());
+    CHECK(strict.run());
+    REQUIRE(strict.error());
+    CHECK(strict.error()->offset == unpadded.size() - 1);
+
+#if defined(BASE64_CPP_COROUTINES)
+    base64::decode_job sliced(input, output.data());
+    std::vector<size_t> progress;
+    for (auto const written: base64::decode_slices(sliced, 120))
+        progress.push_back(written);
+    CHECK(sliced.done());
+    CHECK(progress.size() == (data.size() + 119) / 120);
+    CHECK(progress.back() == data.size());
+    CHECK(std::string(output.begin(), output.end()) == data);
+#endif
+}
+
+TEST_CASE("decode.strict")
+{
+    using base64::decode_mode;
+
+    auto const strictOffset = [](std::string_view _input) -> size_t {
+        try
+        {
+            base64::decode<decode_mode::strict>(_input);
+        }
+        catch (base64::detail::decoder::invalid_input const& e)
+        {
+            return e.offset;
+        }
+        return size_t(-1);
+    };
+
+    // canonical encodings
+    CHECK(base64::decode<decode_mode::strict>(""sv) == "");
+    CHECK(base64::decode<decode_mode::strict>("YQ=="sv) == "a");
+    CHECK(base64::decode<decode_mode::strict>("YWI="sv) == "ab");
+    CHECK(base64::decode<decode_mode::strict>("YWJj"sv) == "abc");
+    CHECK(base64::decode<decode_mode::strict>("MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBR"sv) == "123456789012ABCDEF1234PQ");
+    CHECK(base64::decode<decode_mode::strict>("MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBRYQ=="sv) == "123456789012ABCDEF1234PQa");
+
+    std::string data;
+    for (int i = 0; i < 200; ++i)
+    {
+        auto const input = base64::encode(data);
+        CHECK(base64::decode<decode_mode::strict>(input) == data);
+        data.push_back(static_cast<char>(i * 7 + 3));
+    }
+
+    // accepted by the lenient decoder, but not canonical
+    CHECK(base64::decode("YQ"sv) == "a");
+    CHECK(strictOffset("YQ"sv) == 1);         // missing padding
+    CHECK(strictOffset("YQ="sv) == 2);        // incomplete padding
+    CHECK(strictOffset("YQ==="sv) == 4);      // excess padding
+    CHECK(strictOffset("YWI=YWJj"sv) == 3);   // '=' in the middle
+    CHECK(strictOffset("YW=j"sv) == 2);       // '=' in the middle of the final group
+    CHECK(strictOffset("Y==="sv) == 1);       // too much padding
+    CHECK(strictOffset("===="sv) == 0);
+    CHECK(base64::decode("YR=="sv) == "a");
+    CHECK(strictOffset("YR=="sv) == 1);       // non-zero leftover bits
+    CHECK(strictOffset("YWJ="sv) == 2);       // non-zero leftover bits
+    CHECK(strictOffset("MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBRYR=="sv) == 33);
+    CHECK(strictOffset("MTIzNDU2Nzg5MDEy=UJDREVGMTIzNFBRYQ=="sv) == 16);
+    CHECK(strictOffset("MTIzNDU2Nzg5MDEyQUJDREVGMTIzNF*RYQ=="sv) == 30);
+}
+
+TEST_CASE("decode.trusted")
+{
+    using base64::decode_mode;
+
+    auto const available = base64::detail::cpu::available_features();
+
+    // every byte value, so that every alphabet character occurs at every offset
+    std::string data;
+    for (int i = 0; i < 300; ++i)
+        data.push_back(static_cast<char>(i * 37 + 11));
+
+    for (size_t size: {0u, 12u, 24u, 36u, 48u, 96u, 108u, 300u})
+    {
+        auto const input = base64::encode(std::string_view(data).substr(0, size));
+        for (auto const& kernel: base64::detail::decoder::trusted_kernels)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << size);
+
+            std::string output(size + 1, '#');
+            kernel.function(reinterpret_cast<uint8_t const*>(input.data()),
+                            input.size(),
+                            reinterpret_cast<uint8_t*>(output.data()));
+            CHECK(output.substr(0, size) == data.substr(0, size));
+            CHECK(output.back() == '#');
+
+            // unspecified, but in bounds
+            auto invalid = input;
+            for (size_t i = 0; i < invalid.size(); i += 3)
+                invalid[i] = static_cast<char>(i * 13);
+            kernel.function(reinterpret_cast<uint8_t const*>(invalid.data()),
+                            invalid.size(),
+                            reinterpret_cast<uint8_t*>(output.data()));
+            CHECK(output.back() == '#');
+        }
+    }
+
+    std::string prefix;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        auto const input = base64::encode(prefix);
+        CHECK(base64::decode<decode_mode::trusted>(input) == prefix);
+        prefix.push_back(data[i]);
+    }
+    CHECK(base64::decode<decode_mode::trusted>("MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBRYQ"sv) == "123456789012ABCDEF1234PQa");
+    CHECK(base64::decode<decode_mode::trusted>("MTIz-NDU2Nzg5MDEy"sv).size() == 12);
+}
+
+TEST_CASE("decode-until")
+{
+    auto const terminators = base64::terminator_set("\x07\x1b"sv);
+
+    // built at compile time, where base64 characters or '=' would not compile
+    constexpr auto quote = base64::terminator_set("\"}"sv);
+    static_assert(quote.contains('"') && quote.contains('}') && !quote.contains('A'));
+
+    auto const available = base64::detail::cpu::available_features();
+
+    std::string data;
+    for (int i = 0; i < 100; ++i)
+        data.push_back(static_cast<char>(i * 11 + 1));
+
+    for (auto const& kernel: base64::detail::decoder::prefix_kernels)
+    {
+        if (!base64::detail::dispatch::is_supported(kernel, available))
+            continue;
+        base64::detail::decoder::selected_prefix_kernel() = kernel.function;
+
+        for (size_t size = 0; size < data.size(); ++size)
+        {
+            INFO(kernel.name << " " << size);
+            auto const payload = base64::encode(std::string_view(data).substr(0, size));
+            std::vector<uint8_t> output(payload.size() + 16);
+
+            // OSC payload terminated by ST (ESC '\')
+            auto const sequence = payload + "\x1b\\trailing"s;
+            auto const result = base64::decode_until(sequence, terminators, output.data());
+            CHECK(result.reason == base64::stop_reason::terminator);
+            CHECK(result.chars_consumed == payload.size());
+            CHECK(result.bytes_written == size);
+            CHECK(std::string(output.begin(), output.begin() + result.bytes_written) == data.substr(0, size));
+
+            auto const whole = base64::decode_until(payload, terminators, output.data());
+            CHECK(whole.reason == base64::stop_reason::end_of_input);
+            CHECK(whole.chars_consumed == payload.size());
+            CHECK(whole.bytes_written == size);
+        }
+
+        auto const invalid = base64::decode_until("YWJjZGVm*GhpamtsbW5vcHFy\x07"sv, terminators, std::vector<uint8_t>(32).data());
+        CHECK(invalid.reason == base64::stop_reason::invalid);
+        CHECK(invalid.chars_consumed == 8);
+        CHECK(invalid.bytes_written == 6);
+    }
+
+    base64::detail::decoder::selected_prefix_kernel() = base64::detail::dispatch::select(base64::detail::decoder::prefix_kernels);
+}
+
+TEST_CASE("decode.json")
+{
+    auto const available = base64::detail::cpu::available_features();
+
+    // many '/' in the encoding (0xff), in ever changing positions
+    std::string data;
+    for (int i = 0; i < 300; ++i)
+        data.push_back(static_cast<char>(i % 3 ? 0xff : i * 37 + 11));
+
+    auto const escape = [](std::string_view _payload) {
+        std::string escaped;
+        for (auto const c: _payload)
+        {
+            if (c == '/')
+                escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    };
+
+    for (auto const& kernel: base64::detail::decoder::json_kernels)
+    {
+        if (!base64::detail::dispatch::is_supported(kernel, available))
+            continue;
+        base64::detail::decoder::selected_json_kernel() = kernel.function;
+
+        for (size_t size = 0; size <= data.size(); ++size)
+        {
+            INFO(kernel.name << " " << size);
+            auto const expected = data.substr(0, size);
+            auto const payload = base64::encode(expected);
+
+            for (auto const& body: {payload, escape(payload)})
+            {
+                // exactly sized, so that reading past the input is caught by the sanitizers
+                auto const json = body + "\",\"next\":1}"s;
+                auto const input = std::vector<char>(json.begin(), json.end());
+                std::vector<uint8_t> output((3 * input.size()) / 4);
+
+                auto const result = base64::decode_json_string(std::string_view(input.data(), input.size()), output.data());
+                CHECK(result.reason == base64::stop_reason::terminator);
+                CHECK(result.chars_consumed == body.size());
+                CHECK(result.bytes_written == size);
+                CHECK(std::string(output.begin(), output.begin() + static_cast<std::ptrdiff_t>(result.bytes_written)) == expected);
+
+                auto const unterminated = std::vector<char>(body.begin(), body.end());
+                auto const whole = base64::decode_json_string(std::string_view(unterminated.data(), unterminated.size()), output.data());
+                CHECK(whole.reason == base64::stop_reason::end_of_input);
+                CHECK(whole.chars_consumed == body.size());
+                CHECK(whole.bytes_written == size);
+            }
+        }
+
+        // an invalid character anywhere, also in place of an escaped '/'
+        auto const body = escape(base64::encode(std::string_view(data).substr(0, 100)));
+        std::vector<uint8_t> output(body.size());
+        for (size_t k = 0; k < body.size(); ++k)
+        {
+            INFO(kernel.name << " " << k);
+            auto invalid = body + '"';
+            invalid[k] = '*';
+            auto const result = base64::decode_json_string(invalid, output.data());
+            CHECK(result.reason == base64::stop_reason::invalid);
+            CHECK(result.chars_consumed == (k > 0 && body[k] == '/' && body[k - 1] == '\\' ? k - 1 : k));
+        }
+
+        // escapes other than "\/"
+        CHECK(base64::decode_json_string("YWJjZGVmZ2hpamtsbW5v\\ncHFy\""sv, output.data()).chars_consumed == 20);
+        CHECK(base64::decode_json_string("YWJjZGVm\\u002FZ2hpamtsbW5vcHFy\""sv, output.data()).reason == base64::stop_reason::invalid);
+        auto const slash = base64::decode_json_string("\\/\\/\\/\\/\\/\\/\\/\\/\\/\\/\\/\\/\\/\\/\\/\\/\\/\\/\\/\\/=\""sv, output.data());
+        CHECK(slash.reason == base64::stop_reason::terminator);
+        CHECK(slash.chars_consumed == 41);
+        CHECK(slash.bytes_written == 15);
+        CHECK(std::string(output.begin(), output.begin() + 15) == std::string(15, '\xff'));
+    }
+
+    base64::detail::decoder::selected_json_kernel() = base64::detail::dispatch::select(base64::detail::decoder::json_kernels);
+}
+
+namespace
+{
+// Same layout as struct iovec, without depending on <sys/uio.h>.
+struct io_segment
+{
+    void* iov_base;
+    size_t iov_len;
+};
+
+// Splits [_data, _data + _size) into segments of the given sizes, the last one taking the rest.
+template <typename T>
+std::vector<T> split(char* _data, size_t _size, std::vector<size_t> const& _sizes)
+{
+    std::vector<T> segments;
+    for (auto const size: _sizes)
+    {
+        auto const n = std::min(size, _size);
+        segments.push_back(T{_data, n});
+        _data += n;
+        _size -= n;
+    }
+    segments.push_back(T{_data, _size});
+    return segments;
+}
+}
+
+TEST_CASE("decode.segments")
+{
+    std::string data;
+    for (int i = 0; i < 200; ++i)
+        data.push_back(static_cast<char>(i * 7 + 3));
+    auto encoded = base64::encode(std::string_view(data));
+    auto const expected = base64::decode(std::string_view(encoded));
+
+    for (auto const& sizes: std::vector<std::vector<size_t>> {
+             {},
+             {0, 0},
+             {1},
+             {15, 1, 16, 17},
+             {3, 5, 7, 11, 13},
+             {encoded.size() - 1},
+             {encoded.size() - 2, 1},
+             {40, 0, 33, 100},
+         })
+    {
+        for (auto const& outputSizes: std::vector<std::vector<size_t>> {{}, {11, 1, 12, 13}, {5, 0, 100}})
+        {
+            INFO(sizes.size() << " " << outputSizes.size());
+            auto const input = split<std::string_view>(encoded.data(), encoded.size(), sizes);
+
+            std::string output(expected.size(), '\0');
+            auto const outputSegments = split<io_segment>(output.data(), output.size(), outputSizes);
+
+            CHECK(base64::decode(input, outputSegments) == expected.size());
+            CHECK(output == expected);
+        }
+    }
+
+    // padding split across segments
+    auto const padded = "YWJjZGVmZ2hpamtsbW5vcA=="s;
+    auto const paddedInput = std::vector<std::string_view> {"YWJjZGVmZ2hpamtsbW5vcA="sv, "="sv, ""sv};
+    std::string paddedOutput(17, '\0');
+    CHECK(base64::decode(paddedInput, std::vector<io_segment> {{paddedOutput.data(), paddedOutput.size()}}) == 16);
+    CHECK(paddedOutput.substr(0, 16) == "abcdefghijklmnop");
+
+    // too little output room: the output stops at the end of the segments
+    for (auto const& outputSizes: std::vector<std::vector<size_t>> {{}, {7, 12}, {0, 30, 0}})
+    {
+        INFO(outputSizes.size());
+        auto const input = split<std::string_view>(encoded.data(), encoded.size(), {15, 1, 16, 17});
+        std::string output(expected.size() - 5, '\0');
+        auto const outputSegments = split<io_segment>(output.data(), output.size(), outputSizes);
+
+        CHECK(base64::decode(input, outputSegments) == output.size());
+        CHECK(output == expected.substr(0, output.size()));
+    }
+    CHECK(base64::decode(std::vector<std::string_view> {encoded}, std::vector<io_segment> {}) == 0);
+
+    // invalid byte in a stitched block reports the offset into the concatenated input
+    auto const invalid = std::vector<std::string_view> {"YWJjZGVmZ2hp"sv, "am*sbW5vcHFy"sv, "c3R1"sv};
+    std::string invalidOutput(32, '\0');
+    try
+    {
+        base64::decode(invalid, std::vector<io_segment> {{invalidOutput.data(), invalidOutput.size()}});
+        FAIL("expected invalid_input");
+    }
+    catch (base64::detail::decoder::invalid_input const& e)
+    {
+        CHECK(e.offset == 14);
+        CHECK(e.byte == '*');
+    }
+}
+
+TEST_CASE("decode.iterators")
+{
+    using base64::decode_mode;
+    using base64::detail::iterator::is_contiguous_bytes_v;
+
+    static_assert(is_contiguous_bytes_v<char const*>);
+    static_assert(is_contiguous_bytes_v<std::string::const_iterator>);
+    static_assert(is_contiguous_bytes_v<std::vector<std::byte>::iterator>);
+    static_assert(!is_contiguous_bytes_v<std::list<char>::iterator>);
+    static_assert(!is_contiguous_bytes_v<std::vector<int>::iterator>);
+
+    std::string data;
+    for (int i = 0; i < 10000; ++i)
+        data.push_back(static_cast<char>(i * 37 + 11));
+
+    // sizes around the staging buffer, which is only used for non-contiguous iterators
+    for (size_t size: {0u, 1u, 2u, 12u, 13u, 3071u, 3072u, 3073u, 6200u, 10000u})
+    {
+        auto const expected = data.substr(0, size);
+        auto const encoded = base64::encode(expected);
+        INFO(size);
+
+        auto const chars = std::vector<char>(encoded.begin(), encoded.end());
+        auto const list = std::list<char>(encoded.begin(), encoded.end());
+
+        std::vector<std::byte> bytes(size);
+        auto const end = base64::decode(chars.begin(), chars.end(), bytes.begin());
+        CHECK(end == bytes.end());
+        CHECK(std::equal(bytes.begin(), bytes.end(), expected.begin(), [](std::byte a, char b) {
+            return a == static_cast<std::byte>(b);
+        }));
+
+        std::string output;
+        base64::decode(chars.begin(), chars.end(), std::back_inserter(output));
+        CHECK(output == expected);
+
+        output.clear();
+        base64::decode<decode_mode::strict>(list.begin(), list.end(), std::back_inserter(output));
+        CHECK(output == expected);
+
+        std::deque<uint8_t> deque(size);
+        CHECK(base64::decode(list.begin(), list.end(), deque.begin()) == deque.end());
+        CHECK(std::equal(deque.begin(), deque.end(), expected.begin(), [](uint8_t a, char b) {
+            return a == static_cast<uint8_t>(b);
+        }));
+
+        std::istringstream stream(encoded);
+        output.clear();
+        base64::decode<decode_mode::trusted>(
+            std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>(), std::back_inserter(output));
+        CHECK(output == expected);
+    }
+
+    // errors report the offset into the whole input
+    auto const offsetOf = [](std::list<char> const& _input) -> size_t {
+        try
+        {
+            std::string output;
+            base64::decode<decode_mode::strict>(_input.begin(), _input.end(), std::back_inserter(output));
+        }
+        catch (base64::detail::decoder::invalid_input const& e)
+        {
+            return e.offset;
+        }
+        return size_t(-1);
+    };
+    auto encoded = base64::encode(std::string_view(data));
+    encoded[5000] = '*';
+    CHECK(offsetOf(std::list<char>(encoded.begin(), encoded.end())) == 5000);
+    encoded[5000] = 'A';
+    encoded[encoded.size() - 3] = '*';
+    CHECK(offsetOf(std::list<char>(encoded.begin(), encoded.end())) == encoded.size() - 3);
+
+    // a padding run longer than the staging buffer
+    auto const padded = "YQ" + std::string(5000, '=');
+    std::string output;
+    base64::decode(padded.begin(), padded.end(), std::back_inserter(output));
+    CHECK(output == "a");
+    output.clear();
+    auto const paddedList = std::list<char>(padded.begin(), padded.end());
+    base64::decode(paddedList.begin(), paddedList.end(), std::back_inserter(output));
+    CHECK(output == "a");
+}
+
+namespace
+{
+    template <size_t N, typename = void>
+    struct decodesWithDefaultSize: std::false_type
+    {
+    };
+
+    template <size_t N>
+    struct decodesWithDefaultSize<N, std::void_t<decltype(base64::decode<N>(std::declval<char const (&)[N]>()))>>:
+        std::true_type
+    {
+    };
+
+    /// Checks all fixed size kernels for N characters of M bytes against decode().
+    template <size_t N, size_t M>
+    void checkFixedKernels(std::string const& _data)
+    {
+        auto const available = base64::detail::cpu::available_features();
+        auto const encoded = base64::encode(std::string_view(_data).substr(0, M)).substr(0, N);
+        REQUIRE(encoded.size() == N);
+
+        for (auto const& kernel: base64::detail::fixed::decode_kernels<N, M>)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << N << " " << M);
+
+            std::array<uint8_t, M + 1> output;
+            output.back() = '#';
+            kernel.function(reinterpret_cast<uint8_t const*>(encoded.data()), output.data());
+            CHECK(std::equal(output.begin(), output.begin() + M, _data.begin(), [](uint8_t a, char b) {
+                return a == static_cast<uint8_t>(b);
+            }));
+            CHECK(output.back() == '#');
+
+            for (size_t i = 0; i < N; i += 3)
+            {
+                auto invalid = encoded;
+                invalid[i] = invalid[i] == '=' ? 'A' : '*';
+                try
+                {
+                    kernel.function(reinterpret_cast<uint8_t const*>(invalid.data()), output.data());
+                    FAIL("invalid_input expected");
+                }
+                catch (base64::detail::decoder::invalid_input const& e)
+                {
+                    CHECK(e.offset == i);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("decode.fixed")
+{
+    std::string data;
+    for (int i = 0; i < 100; ++i)
+        data.push_back(static_cast<char>(i * 37 + 11));
+
+    checkFixedKernels<4, 3>(data);
+    checkFixedKernels<2, 1>(data);
+    checkFixedKernels<4, 1>(data);
+    checkFixedKernels<22, 16>(data);
+    checkFixedKernels<24, 16>(data);
+    checkFixedKernels<43, 32>(data);
+    checkFixedKernels<44, 32>(data);
+    checkFixedKernels<64, 48>(data);
+    checkFixedKernels<86, 64>(data);
+    checkFixedKernels<88, 64>(data);
+
+    // SHA-256 of "abc", as a padded field and as a string literal
+    char const digest[44] = { 'u', 'n', '7', 'q', 'u', 'B', 'h', 'b', 'U', 'P', 'c', 'D', 'n', 'B', 'X', 'n',
+                              'Z', 'P', 'w', 'u', 'e', 'g', 'K', '0', 'e', 'k', '+', '+', 'P', 'w', 'u', '5',
+                              'N', '0', 'Y', 'A', 'I', 'x', 'm', '+', 'w', 'v', 'A', '=' };
+    auto const bytes = base64::decode<44, 32>(digest);
+    CHECK(bytes == base64::decode<44, 32>("un7quBhbUPcDnBXnZPwuegK0ek++Pwu5N0YAIxm+wvA="));
+    CHECK(base64::encode(bytes) == std::array<char, 44> { 'u', 'n', '7', 'q', 'u', 'B', 'h', 'b', 'U', 'P', 'c',
+                                                          'D', 'n', 'B', 'X', 'n', 'Z', 'P', 'w', 'u', 'e', 'g',
+                                                          'K', '0', 'e', 'k', '+', '+', 'P', 'w', 'u', '5', 'N',
+                                                          '0', 'Y', 'A', 'I', 'x', 'm', '+', 'w', 'v', 'A', '=' });
+    CHECK(base64::decode<4, 3>("YWJj") == std::array<uint8_t, 3> { 'a', 'b', 'c' });
+    CHECK(base64::decode<3>("YWJ") == std::array<uint8_t, 2> { 'a', 'b' });
+
+    // the size of fields of a multiple of 4 characters, padded or not, must be given
+    static_assert(decodesWithDefaultSize<22>::value);
+    static_assert(decodesWithDefaultSize<43>::value);
+    static_assert(!decodesWithDefaultSize<24>::value);
+    static_assert(!decodesWithDefaultSize<44>::value);
+    static_assert(!decodesWithDefaultSize<88>::value);
+    CHECK_THROWS_AS((base64::decode<44, 32>("un7quBhbUPcDnBXnZPwuegK0ek++Pwu5N0YAIxm+wvAA")),
+                    base64::detail::decoder::invalid_input);
+
+    // string literals are not fixed size fields
+    CHECK(base64::decode("YWJj") == "abc");
+}
+
+TEST_CASE("autotune")
+{
+    auto const cachePath = std::string("base64-cpp-autotune-test.cache");
+    std::remove(cachePath.c_str());
+
+    auto const tuned = base64::autotune(cachePath);
+    CHECK(!tuned.from_cache);
+    CHECK(base64::detail::autotune::find(base64::detail::decoder::kernels, tuned.decode_kernel) != nullptr);
+    CHECK(base64::detail::autotune::find(base64::detail::encoder::kernels, tuned.encode_kernel) != nullptr);
+    CHECK(base64::decode("YWJjZGVmZ2hpamtsbW5vcHFyc3R1dnd4eXo="sv) == "abcdefghijklmnopqrstuvwxyz");
+    CHECK(base64::encode("abcdefghijklmnopqrstuvwxyz"sv) == "YWJjZGVmZ2hpamtsbW5vcHFyc3R1dnd4eXo=");
+
+    auto const cached = base64::autotune(cachePath);
+    CHECK(cached.from_cache);
+    CHECK(cached.decode_kernel == tuned.decode_kernel);
+    CHECK(cached.encode_kernel == tuned.encode_kernel);
+
+    // entries of other hosts are kept, unknown kernels are ignored
+    {
+        std::ofstream file(cachePath, std::ios::app);
+        file << "decode no-such-kernel Some Other CPU\n";
+    }
+    CHECK(base64::autotune(cachePath).from_cache);
+    CHECK(base64::detail::autotune::read_cache(cachePath).size() == 3);
+
+    std::remove(cachePath.c_str());
+    base64::detail::decoder::selected_kernel() = base64::detail::dispatch::select(base64::detail::decoder::kernels);
+    base64::detail::encoder::selected_kernel() = base64::detail::dispatch::select(base64::detail::encoder::kernels);
+}
+
+TEST_CASE("decode.tail")
+{
+    auto const available = base64::detail::cpu::available_features();
+
+    // Unpadded tails of every length, with an invalid character at every
+    // position.
+    std::vector<std::string> inputs;
+    std::string const alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (size_t size = 0; size < 16; ++size)
+    {
+        auto const valid = alphabet.substr(size * 3, size);
+        inputs.push_back(valid);
+        for (size_t i = 0; i < size; ++i)
+        {
+            auto broken = valid;
+            broken[i] = "*=\n\xff"[i % 4];
+            inputs.push_back(broken);
+        }
+    }
+
+    for (auto const& kernel: base64::detail::decoder::tail_kernels)
+    {
+        if (!base64::detail::dispatch::is_supported(kernel, available))
+            continue;
+
+        for (auto const& input: inputs)
+        {
+            INFO(kernel.name << " " << input);
+
+            std::vector<uint8_t> expected(12);
+            auto const expectedSize = base64::detail::decoder::simple::decode(input.begin(), input.end(), expected.data());
+
+            std::vector<uint8_t> output(12);
+            auto const size = kernel.function(reinterpret_cast<uint8_t const*>(input.data()), input.size(), output.data());
+            CHECK(size == expectedSize);
+            CHECK(std::equal(output.begin(), output.begin() + size, expected.begin()));
+        }
+    }
+
+    CHECK(base64::decode("eyJhbGciOiJIUzI1NiIsInR5cCI6IkpXVCJ9"sv) == R"({"alg":"HS256","typ":"JWT"})");
+    CHECK(base64::decode("YWJjZA"sv) == "abcd");
+    CHECK(base64::decode("YWJjZA=="sv) == "abcd");
+}
@@ -0,0 +1,252 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <base64-cpp/decode.hpp>
+#include <base64-cpp/encode.hpp>
+#include <base64-cpp/fixed.hpp>
+#include <base64-cpp/framing.hpp>
+#include <base64-cpp/iterator.hpp>
+#include <base64-cpp/scatter.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+TEST_CASE("base64.encode", "[simple]")
+{
+    CHECK(base64::encode(""sv) == "");
+    CHECK(base64::encode("a"sv) == "YQ==");
+    CHECK(base64::encode("ab"sv) == "YWI=");
+    CHECK(base64::encode("abc"sv) == "YWJj");
+    CHECK(base64::encode("abcd"sv) == "YWJjZA==");
+    CHECK(base64::encode("foo:bar"sv) == "Zm9vOmJhcg==");
+}
+
+TEST_CASE("base64.encode.accelerated")
+{
+    CHECK(base64::encode("1234567890ab"sv) == "MTIzNDU2Nzg5MGFi");
+    CHECK(base64::encode("123456789012ABCDEF1234PQ"sv) == "MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBR");
+    CHECK(base64::encode("123456789012ABCDEF1234PQa"sv) == "MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBRYQ==");
+    CHECK(base64::encode("123456789012ABCDEF1234PQab"sv) == "MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBRYWI=");
+    CHECK(base64::encode("123456789012ABCDEF1234PQabc"sv) == "MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBRYWJj");
+}
+
+TEST_CASE("base64.encode.roundtrip")
+{
+    std::string input;
+    for (int i = 0; i < 300; ++i)
+    {
+        CHECK(base64::decode(base64::encode(input)) == input);
+        input.push_back(static_cast<char>(i * 7 + 3));
+    }
+}
+
+TEST_CASE("base64.encode.kernels")
+{
+    auto const available = base64::detail::cpu::available_features();
+
+    std::string data;
+    for (int i = 0; i < 300; ++i)
+        data.push_back(static_cast<char>(i * 37 + 11));
+
+    for (size_t size: {0u, 12u, 24u, 36u, 48u, 60u, 72u, 96u, 108u, 300u})
+    {
+        auto const expected = base64::encode(std::string_view(data).substr(0, size));
+
+        // exactly sized, so that reading past the input is caught by the sanitizers
+        auto const input = std::vector<uint8_t>(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(size));
+
+        for (auto const& kernel: base64::detail::encoder::kernels)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << size);
+            std::string output(expected.size(), '\0');
+            kernel.function(input.data(), size, reinterpret_cast<uint8_t*>(output.data()));
+            CHECK(output == expected);
+        }
+    }
+}
+
+TEST_CASE("base64.encode.segments")
+{
+    std::string data;
+    for (int i = 0; i < 200; ++i)
+        data.push_back(static_cast<char>(i * 13 + 5));
+
+    for (size_t size: {size_t(0), size_t(1), size_t(11), size_t(12), size_t(37), data.size()})
+    {
+        auto const input = std::string_view(data).substr(0, size);
+        auto const expected = base64::encode(input);
+
+        for (auto const& cuts: std::vector<std::vector<size_t>> {{}, {1, 1}, {5, 11, 0, 7}, {12, 24}})
+        {
+            INFO(size << " " << cuts.size());
+            std::vector<std::string_view> inputSegments;
+            std::vector<std::string> outputSegments;
+            auto rest = input;
+            for (auto const cut: cuts)
+            {
+                auto const n = std::min(cut, rest.size());
+                inputSegments.push_back(rest.substr(0, n));
+                rest.remove_prefix(n);
+                outputSegments.emplace_back(cut + 3, '\0');
+            }
+            inputSegments.push_back(rest);
+            outputSegments.emplace_back(expected.size(), '\0');
+
+            auto const written = base64::encode(inputSegments, outputSegments);
+            CHECK(written == expected.size());
+
+            std::string output;
+            for (auto const& segment: outputSegments)
+                output += segment;
+            CHECK(output.substr(0, written) == expected);
+        }
+    }
+
+    // too little output room: the output stops at the end of the segments
+    auto const expected = base64::encode(std::string_view(data));
+    for (auto const& cuts: std::vector<std::vector<size_t>> {{}, {13, 50}, {0, 100, 0}})
+    {
+        INFO(cuts.size());
+        std::vector<std::string> outputSegments;
+        size_t rest = expected.size() - 7;
+        for (auto const cut: cuts)
+        {
+            outputSegments.emplace_back(cut, '\0');
+            rest -= cut;
+        }
+        outputSegments.emplace_back(rest, '\0');
+
+        CHECK(base64::encode(std::vector<std::string_view> {data}, outputSegments) == expected.size() - 7);
+
+        std::string output;
+        for (auto const& segment: outputSegments)
+            output += segment;
+        CHECK(output == expected.substr(0, output.size()));
+    }
+}
+
+TEST_CASE("base64.encode.iterators")
+{
+    std::string data;
+    for (int i = 0; i < 7000; ++i)
+        data.push_back(static_cast<char>(i * 13 + 5));
+
+    for (size_t size: {size_t(0), size_t(1), size_t(11), size_t(12), size_t(3072), size_t(3073), data.size()})
+    {
+        INFO(size);
+        auto const input = std::string_view(data).substr(0, size);
+        auto const expected = base64::encode(input);
+
+        std::vector<std::byte> bytes(size);
+        std::transform(input.begin(), input.end(), bytes.begin(), [](char c) { return static_cast<std::byte>(c); });
+
+        std::vector<char> chars(expected.size());
+        CHECK(base64::encode(bytes.begin(), bytes.end(), chars.begin()) == chars.end());
+        CHECK(std::string(chars.begin(), chars.end()) == expected);
+
+        std::string output;
+        base64::encode(input.begin(), input.end(), std::back_inserter(output));
+        CHECK(output == expected);
+
+        auto const list = std::list<unsigned char>(input.begin(), input.end());
+        output.clear();
+        base64::encode(list.begin(), list.end(), std::back_inserter(output));
+        CHECK(output == expected);
+    }
+}
+
+TEST_CASE("base64.encode.framed")
+{
+    // OSC 52: a single chunk
+    auto const osc52 = base64::framing { "\033]52;c;", {}, {}, "\033\\" };
+    CHECK(base64::encode_framed("abcd"sv, osc52) == "\033]52;c;YWJjZA==\033\\");
+    CHECK(base64::encode_framed(""sv, osc52) == "\033]52;c;\033\\");
+
+    std::string data;
+    for (int i = 0; i < 10000; ++i)
+        data.push_back(static_cast<char>(i * 13 + 5));
+
+    auto const kitty = base64::framing { "<first>", "<more>", "<last>", "</>", 4096 };
+    for (auto const chunkSize: {size_t(4096), size_t(4), size_t(7), size_t(100)})
+    {
+        auto framing = kitty;
+        framing.chunk_size = chunkSize;
+        auto const payloadSize = std::max(chunkSize, size_t(4)) & ~size_t(3);
+
+        for (size_t size: {size_t(0), size_t(1), size_t(3071), size_t(3072), size_t(3073), size_t(6144), data.size()})
+        {
+            INFO(chunkSize << " " << size);
+            auto const input = std::string_view(data).substr(0, size);
+            auto const encoded = base64::encode(input);
+
+            std::string expected;
+            size_t chunks = 0;
+            for (size_t offset = 0; offset < encoded.size() || offset == 0; offset += payloadSize)
+            {
+                auto const last = offset + payloadSize >= encoded.size();
+                expected += offset == 0 ? "<first>" : last ? "<last>" : "<more>";
+                expected += encoded.substr(offset, payloadSize);
+                expected += "</>";
+                ++chunks;
+            }
+
+            CHECK(base64::chunk_count(size, framing) == chunks);
+            CHECK(base64::framed_size(size, framing) == expected.size());
+            CHECK(base64::encode_framed(input, framing) == expected);
+        }
+    }
+}
+
+namespace
+{
+    template <size_t M>
+    void checkFixedEncodeKernels(std::string const& _data)
+    {
+        auto const available = base64::detail::cpu::available_features();
+        auto const expected = base64::encode(std::string_view(_data).substr(0, M));
+
+        for (auto const& kernel: base64::detail::fixed::encode_kernels<M>)
+        {
+            if (!base64::detail::dispatch::is_supported(kernel, available))
+                continue;
+            INFO(kernel.name << " " << M);
+
+            std::string output(expected.size() + 1, '#');
+            kernel.function(reinterpret_cast<uint8_t const*>(_data.data()), reinterpret_cast<uint8_t*>(output.data()));
+            CHECK(output.substr(0, expected.size()) == expected);
+            CHECK(output.back() == '#');
+        }
+    }
+}
+
+TEST_CASE("base64.encode.fixed")
+{
+    std::string data;
+    for (int i = 0; i < 100; ++i)
+        data.push_back(static_cast<char>(i * 13 + 5));
+
+    checkFixedEncodeKernels<1>(data);
+    checkFixedEncodeKernels<2>(data);
+    checkFixedEncodeKernels<3>(data);
+    checkFixedEncodeKernels<11>(data);
+    checkFixedEncodeKernels<12>(data);
+    checkFixedEncodeKernels<16>(data);
+    checkFixedEncodeKernels<24>(data);
+    checkFixedEncodeKernels<32>(data);
+    checkFixedEncodeKernels<64>(data);
+    checkFixedEncodeKernels<100>(data);
+
+    uint8_t const uuid[16] = { 0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3,
+                               0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00 };
+    auto const encoded = base64::encode(uuid);
+    CHECK(std::string_view(encoded.data(), encoded.size()) == "Ej5FZ+ibEtOkVkJmFBdAAA==");
+}
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <base64-cpp/encode.hpp>
+#include <base64-cpp/inflate.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <zlib.h>
+
+using namespace std::string_view_literals;
+
+namespace
+{
+    /// Pixel-like data that compresses well, but not trivially.
+    std::string sample(size_t _size)
+    {
+        std::string data;
+        for (size_t i = 0; i < _size; ++i)
+            data.push_back(static_cast<char>((i / 7) * 3 + (i % 4 == 3 ? 0xff : i % 5)));
+        return data;
+    }
+
+    std::string compress(std::string_view _data)
+    {
+        auto size = compressBound(static_cast<uLong>(_data.size()));
+        std::string output(size, '\0');
+        REQUIRE(::compress(reinterpret_cast<Bytef*>(output.data()),
+                           &size,
+                           reinterpret_cast<Bytef const*>(_data.data()),
+                           static_cast<uLong>(_data.size()))
+                == Z_OK);
+        output.resize(size);
+        return output;
+    }
+}
+
+TEST_CASE("inflate.decode")
+{
+    for (size_t size: {0u, 1u, 100u, 5000u, 100000u, 1000000u})
+    {
+        INFO(size);
+        auto const data = sample(size);
+        auto const payload = base64::encode(compress(data));
+
+        CHECK(base64::decode_inflate(payload) == data);
+
+        std::string output(size, '\0');
+        CHECK(base64::decode_inflate(payload, reinterpret_cast<uint8_t*>(output.data()), output.size()) == size);
+        CHECK(output == data);
+    }
+}
+
+TEST_CASE("inflate.streaming")
+{
+    auto const data = sample(300000);
+    auto const payload = base64::encode(compress(data));
+
+    // e.g. Kitty graphics chunks of 4096 characters, and odd splits
+    for (size_t chunkSize: {size_t(1), size_t(7), size_t(16), size_t(4096), size_t(50001)})
+    {
+        INFO(chunkSize);
+        std::string output;
+        size_t calls = 0;
+        auto const sink = [&](uint8_t const* _data, size_t _size) {
+            CHECK(_size <= base64::detail::inflate::output_chunk_size);
+            output.append(reinterpret_cast<char const*>(_data), _size);
+            ++calls;
+        };
+
+        base64::inflate_decoder decoder;
+        for (size_t i = 0; i < payload.size(); i += chunkSize)
+            decoder.write(std::string_view(payload).substr(i, chunkSize), sink);
+        CHECK(decoder.finish(sink) == data.size());
+        CHECK(decoder.position() == payload.size());
+        CHECK(output == data);
+        CHECK(calls >= data.size() / base64::detail::inflate::output_chunk_size);
+    }
+}
+
+TEST_CASE("inflate.errors")
+{
+    auto const data = sample(100000);
+    auto const payload = base64::encode(compress(data));
+
+    // invalid base64, reported with the offset into the whole payload
+    auto const at = payload.size() / 2;
+    auto invalid = payload;
+    invalid[at] = '*';
+    base64::inflate_decoder decoder;
+    try
+    {
+        for (size_t i = 0; i < invalid.size(); i += 100)
+            decoder.write(std::string_view(invalid).substr(i, 100), [](uint8_t const*, size_t) {});
+        FAIL("invalid_input expected");
+    }
+    catch (base64::detail::decoder::invalid_input const& e)
+    {
+        CHECK(e.offset == at);
+        CHECK(e.byte == '*');
+    }
+
+    // valid base64, but not a compressed stream
+    CHECK_THROWS_AS(base64::decode_inflate(base64::encode("not a zlib stream, not at all"sv)), base64::inflate_error);
+
+    // truncated stream
+    CHECK_THROWS_AS(base64::decode_inflate(payload.substr(0, (payload.size() / 2) & ~size_t(3))), base64::inflate_error);
+
+    // output buffer too small
+    std::string output(data.size() - 1, '\0');
+    CHECK_THROWS_AS(base64::decode_inflate(payload, reinterpret_cast<uint8_t*>(output.data()), output.size()),
+                    base64::inflate_error);
+
+    // trailing data after the end of the stream
+    CHECK_THROWS_AS(base64::decode_inflate(base64::encode(compress(data) + "trailing")), base64::inflate_error);
+}
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <base64-cpp/views.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <list>
+#include <string>
+#include <string_view>
+
+#include <range/v3/view/take.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+    template <typename Range>
+    std::string collect(Range&& _range)
+    {
+        std::string output;
+        for (auto const value: _range)
+            output.push_back(static_cast<char>(value));
+        return output;
+    }
+}
+
+TEST_CASE("views.decode")
+{
+    CHECK(collect(base64::views::decode(""sv)).empty());
+    CHECK(collect("YWJjZA=="sv | base64::views::decode) == "abcd");
+    CHECK(collect("MTIzNDU2Nzg5MGFi"sv | base64::views::decode) == "1234567890ab");
+    CHECK(collect("MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBRYQ=="sv | base64::views::decode) == "123456789012ABCDEF1234PQa");
+}
+
+TEST_CASE("views.decode.non_contiguous")
+{
+    auto const input = "MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBRYWI="sv;
+    auto const list = std::list<char>(input.begin(), input.end());
+    CHECK(collect(list | base64::views::decode) == "123456789012ABCDEF1234PQab");
+}
+
+TEST_CASE("views.decode.lazy")
+{
+    // The invalid character sits in the second block, which is never decoded.
+    auto const input = "MTIzNDU2Nzg5MGFi****************"sv;
+    auto view = base64::views::decode(input);
+    auto i = view.begin();
+    CHECK(*i == '1');
+    for (int k = 0; k < 11; ++k)
+        ++i;
+    CHECK(*i == 'b');
+    CHECK_THROWS_AS(++i, base64::detail::decoder::invalid_input);
+}
+
+TEST_CASE("views.decode.range-v3")
+{
+    auto const input = "MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBR"sv;
+    CHECK(collect(input | base64::views::decode | ranges::views::take(4)) == "1234");
+}
+
+TEST_CASE("views.encode")
+{
+    CHECK(collect(base64::views::encode(""sv)).empty());
+    CHECK(collect("abcd"sv | base64::views::encode) == "YWJjZA==");
+    CHECK(collect("123456789012ABCDEF1234PQab"sv | base64::views::encode) == "MTIzNDU2Nzg5MDEyQUJDREVGMTIzNFBRYWI=");
+    CHECK(collect(std::string("foo:bar") | base64::views::encode) == "Zm9vOmJhcg==");
+}
+
+TEST_CASE("views.roundtrip")
+{
+    std::string input;
+    for (int i = 0; i < 100; ++i)
+        input.push_back(static_cast<char>(i * 13 + 1));
+    CHECK(collect(input | base64::views::encode | base64::views::decode) == input);
+}